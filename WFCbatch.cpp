@@ -0,0 +1,68 @@
+// Batches - many small grids of one tileset per call, made with BBM on a thread pool
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "wfc/Tile.h"
+#include "wfc/TilesetFile.h"
+#include "wfc/Rules.h"
+#include "wfc/Config.h"
+#include "wfc/Random.h"
+#include "wfc/Grid.h"
+#include "wfc/Display.h"
+#include "wfc/Profile.h"
+#include "wfc/Batch.h"
+
+using namespace std;
+
+// CHANGEABLE CONSTANTS
+
+// the tileset file used when none is given, see wfc/TilesetFile.h
+const char* TILESET = "tilesets/circuit.tiles";
+
+// usage: WFCbatch.exe [count n m threads seed tileset]
+// tileset - a tileset file (see wfc/TilesetFile.h), e.g. tilesets/pipe.tiles
+int main(int argc, char** argv){
+
+    Config config;
+    RunStats stats;
+    config.stats = &stats;
+    int count = 100;
+    config.n = 64;
+    config.m = 64;
+    if(argc >= 2) count = atoi(argv[1]);
+    if(argc >= 4){
+        config.n = atoi(argv[2]);
+        config.m = atoi(argv[3]);
+    }
+    if(argc >= 5) config.threads = atoi(argv[4]);
+    if(count <= 0) return 0;
+
+    uint64_t seed = chrono::steady_clock::now().time_since_epoch().count();
+    if(argc >= 6) seed = strtoull(argv[5],nullptr,10);
+    cerr << "seed " << seed << endl;
+    Rng rng(seed);
+
+    Tileset set;
+    Rules rules = loadTileset(argc >= 7 ? argv[6] : TILESET,set);
+    vector<Tile>& tiles = set.tiles;
+    vector<int> maps((size_t)count*config.n*config.m);
+    auto start = chrono::steady_clock::now();
+    WFCbatch(rules,config,rng,count,maps.data());
+    double seconds = chrono::duration<double>(chrono::steady_clock::now()-start).count();
+
+    cout << "ended" << endl;
+    cerr << count << " grids of " << config.n << "x" << config.m << " in " << seconds << " s, " << count/seconds << " grids/s" << endl;
+
+    // the first grid of the batch
+    Grid<int> first(config.n,config.m,-1,1,OUTSIDE);
+    for(int x = 0; x < config.n; x++){
+        for(int y = 0; y < config.m; y++) first(x,y) = maps[(size_t)x*config.m+y];
+    }
+    displayGenerated(first,tiles);
+
+    profileDump(&stats);
+
+    return 0;
+}
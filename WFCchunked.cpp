@@ -0,0 +1,62 @@
+// Chunked generation - BBM on chunks of the grid, chunks that don't touch are generated in parallel
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "wfc/Tile.h"
+#include "wfc/TilesetFile.h"
+#include "wfc/Rules.h"
+#include "wfc/Config.h"
+#include "wfc/Random.h"
+#include "wfc/Grid.h"
+#include "wfc/Display.h"
+#include "wfc/Output.h"
+#include "wfc/Profile.h"
+#include "wfc/WFCchunked.h"
+
+using namespace std;
+
+// CHANGEABLE CONSTANTS
+
+// the tileset file used when none is given, see wfc/TilesetFile.h
+const char* TILESET = "tilesets/circuit.tiles";
+
+// usage: WFCchunked.exe [n m threads chunkSize seed tileset output]
+// tileset - a tileset file (see wfc/TilesetFile.h), e.g. tilesets/pipe.tiles
+// output - a file to write the grid to instead of printing it, .wfcg for tile indices, .pgm or .ppm for an image
+int main(int argc, char** argv){
+
+    Config config;
+    RunStats stats;
+    config.stats = &stats;
+    config.n = 1000;
+    config.m = 1000;
+    if(argc >= 3){
+        config.n = atoi(argv[1]);
+        config.m = atoi(argv[2]);
+    }
+    if(argc >= 4) config.threads = atoi(argv[3]);
+    if(argc >= 5) config.chunkSize = atoi(argv[4]);
+
+    // the same seed gives the same grid
+    uint64_t seed = chrono::steady_clock::now().time_since_epoch().count();
+    if(argc >= 6) seed = strtoull(argv[5],nullptr,10);
+    cerr << "seed " << seed << endl;
+    Rng rng(seed);
+
+    Tileset set;
+    Rules rules = loadTileset(argc >= 7 ? argv[6] : TILESET,set);
+    vector<Tile>& tiles = set.tiles;
+    Grid<int> generated = WFCchunked(rules,config,rng);
+
+    cout << "ended" << endl;
+
+    if(argc >= 8) writeOutputFile(argv[7],generated,tiles);
+    else displayGenerated(generated,tiles);
+
+    // writes wfc_stats.json when built with WFC_STATS
+    profileDump(&stats);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+// Overlapping model - the tiles are the patterns of a sample image, generated with BBM
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+#include "wfc/Patterns.h"
+#include "wfc/Rules.h"
+#include "wfc/Config.h"
+#include "wfc/Random.h"
+#include "wfc/Grid.h"
+#include "wfc/Display.h"
+#include "wfc/Profile.h"
+#include "wfc/WFCwithBBM.h"
+
+using namespace std;
+
+// CHANGEABLE CONSTANTS
+
+// patterns are PATTERN_SIZE x PATTERN_SIZE windows of the sample with their rotations and mirrors
+const int PATTERN_SIZE = 3;
+const int SYMMETRY = 8;
+
+// usage: WFCoverlapping.exe [n m seed]
+int main(int argc, char** argv){
+
+    Config config;
+    RunStats stats;
+    config.stats = &stats;
+    config.n = 60;
+    config.m = 120;
+    if(argc >= 3){
+        config.n = atoi(argv[1]);
+        config.m = atoi(argv[2]);
+    }
+
+    // the same seed gives the same grid
+    uint64_t seed = chrono::steady_clock::now().time_since_epoch().count();
+    if(argc >= 4) seed = strtoull(argv[3],nullptr,10);
+    cerr << "seed " << seed << endl;
+    Rng rng(seed);
+
+    vector<string> sample = {
+        "                ",
+        " ######  ###### ",
+        " #    #  #    # ",
+        " #    ####    # ",
+        " #            # ",
+        " ###  ####  ### ",
+        "   #  #  #  #   ",
+        "   ####  ####   ",
+        "                ",
+    };
+    Patterns patterns = extractPatterns(sample,PATTERN_SIZE,SYMMETRY,true);
+    cerr << patterns.tiles.size() << " patterns" << endl;
+
+    Rules rules = compileOverlapRules(patterns);
+    Grid<int> generated = WFCwithBBM(rules,config,rng);
+
+    cout << "ended" << endl;
+
+    displayOverlapping(generated,patterns.tiles);
+
+    // writes wfc_stats.json when built with WFC_STATS
+    profileDump(&stats);
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Streaming generation - an endless world printed band by band, memory stays the same however long it runs
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "wfc/Tile.h"
+#include "wfc/TilesetFile.h"
+#include "wfc/Rules.h"
+#include "wfc/Config.h"
+#include "wfc/Random.h"
+#include "wfc/Grid.h"
+#include "wfc/Display.h"
+#include "wfc/Profile.h"
+#include "wfc/WFCstream.h"
+#include "wfc/Mapped.h"
+
+using namespace std;
+
+// CHANGEABLE CONSTANTS
+
+// the tileset file used when none is given, see wfc/TilesetFile.h
+const char* TILESET = "tilesets/circuit.tiles";
+
+// usage: WFCstream.exe [m bands threads seed tileset output], 0 bands - never stops
+// tileset - a tileset file (see wfc/TilesetFile.h), e.g. tilesets/pipe.tiles
+// output - a file the bands are mapped into instead of printing them, see wfc/Mapped.h, needs bands > 0
+int main(int argc, char** argv){
+
+    Config config;
+    RunStats stats;
+    config.stats = &stats;
+    config.m = 200;
+    long long bands = 0;
+    if(argc >= 2) config.m = atoi(argv[1]);
+    if(argc >= 3) bands = atoll(argv[2]);
+    if(argc >= 4) config.threads = atoi(argv[3]);
+
+    // the same seed gives the same grid
+    uint64_t seed = chrono::steady_clock::now().time_since_epoch().count();
+    if(argc >= 5) seed = strtoull(argv[4],nullptr,10);
+    cerr << "seed " << seed << endl;
+    Rng rng(seed);
+
+    Tileset set;
+    Rules rules = loadTileset(argc >= 6 ? argv[5] : TILESET,set);
+    vector<Tile>& tiles = set.tiles;
+    if(argc >= 7){
+        if(bands <= 0){
+            cerr << "a mapped output needs a number of bands" << endl;
+            return 1;
+        }
+        MappedGrid out;
+        out.create(argv[6],bands*config.chunkSize,config.m,tiles);
+        WFCmapped(rules,config,rng,out);
+        profileDump(&stats);
+        return 0;
+    }
+
+    WFCstream(rules,config,rng,[&](Grid<int>& band, long long){
+        displayGenerated(band,tiles);
+        return true;
+    },bands);
+
+    // writes wfc_stats.json when built with WFC_STATS
+    profileDump(&stats);
+
+    return 0;
+}
\ No newline at end of file
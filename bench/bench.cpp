@@ -0,0 +1,146 @@
+// Benchmark of the generators on the built-in tilesets
+// usage: bench [maxSize repeats budgetSeconds]
+//
+// every strategy runs on every tileset at 32x32, 64x64, ... up to maxSize, each case repeats times with
+// seeds 1..repeats, and reports the averages. A strategy stops growing on a tileset once a case takes
+// longer than budgetSeconds, or gives up on it.
+// peak RSS is the peak of the whole process so far, cases run from small to big so it grows with them
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <cstdlib>
+#ifdef _WIN32
+// windows.h defines min and max as macros otherwise, which breaks std::min, std::max and SplitMix::min, max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "../wfc/Library.h"
+
+using namespace std;
+
+// the tilesets every strategy runs on, relative to the repository root
+const char* TILESETS[] = {"tilesets/hash.tiles", "tilesets/pipe.tiles", "tilesets/circuit.tiles", "tilesets/bends.tiles"};
+
+// Reset gives up on a case after this many attempts
+const long long MAX_RESET_ATTEMPTS = 2000;
+
+double peakRssMb(){
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+    return pmc.PeakWorkingSetSize / (1024.0*1024.0);
+#elif defined(__APPLE__)
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / (1024.0*1024.0);
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+struct Strategy{
+    string name;
+    function<Grid<int>(Rules&, Config&, Rng&)> run;
+    // plain WFC has no way out of a conflict
+    bool needsComplete;
+};
+
+Grid<int> boundedReset(Rules& rules, Config& config, Rng& rng){
+    uint64_t seed = rng();
+    SolverContext ctx;
+    for(long long attempt = 0; attempt < MAX_RESET_ATTEMPTS; attempt++){
+        Rng attemptRng(hashKey(seed,attempt));
+        if(attemptReset(rules,config,attemptRng,ctx)) return std::move(ctx.res);
+    }
+    throw runtime_error("gave up");
+}
+// BBM clearing the whole blockRadius around every conflict, to compare the adaptive radius with
+Grid<int> fixedRadiusBBM(Rules& rules, Config& config, Rng& rng){
+    Config fixed = config;
+    fixed.minBlockRadius = fixed.blockRadius;
+    return WFCwithBBM(rules,fixed,rng);
+}
+
+int main(int argc, char** argv){
+    int maxSize = 1024;
+    int repeats = 3;
+    double budget = 10;
+    if(argc >= 2) maxSize = atoi(argv[1]);
+    if(argc >= 3) repeats = atoi(argv[2]);
+    if(argc >= 4) budget = atof(argv[3]);
+
+    vector<Strategy> strategies = {
+        {"WFC", WFC, true},
+        {"BBM", WFCwithBBM, false},
+        {"BBM fixed", fixedRadiusBBM, false},
+        {"Reset", boundedReset, false},
+        {"Backtracking", WFCwithBacktracking, false},
+        {"Chunked", WFCchunked, false},
+    };
+
+    cout << left << setw(14) << "strategy" << setw(9) << "tileset" << right << setw(6) << "size"
+         << setw(11) << "ms" << setw(13) << "cells/s" << setw(10) << "rss MB"
+         << setw(10) << "conflicts" << setw(9) << "wipes" << setw(11) << "wiped" << setw(10) << "restarts"
+         << setw(12) << "backtracks" << endl;
+
+    for(const char* path : TILESETS){
+        Tileset set;
+        Rules rules = loadTileset(path,set);
+        for(Strategy& strategy : strategies){
+            if(strategy.needsComplete && !set.complete) continue;
+            for(int size = 32; size <= maxSize; size *= 2){
+                RunStats stats;
+                Config config;
+                config.n = size;
+                config.m = size;
+                config.stats = &stats;
+
+                double seconds = 0;
+                string failure;
+                for(int seed = 1; seed <= repeats && failure.empty(); seed++){
+                    Rng rng(seed);
+                    auto start = chrono::steady_clock::now();
+                    try{
+                        strategy.run(rules,config,rng);
+                    }catch(exception& e){
+                        failure = e.what();
+                    }
+                    seconds += chrono::duration<double>(chrono::steady_clock::now()-start).count();
+                }
+
+                cout << left << setw(14) << strategy.name << setw(9) << set.name << right << setw(6) << size;
+                if(!failure.empty()){
+                    cout << "  " << failure << endl;
+                    break;
+                }
+                double mean = seconds/repeats;
+                cout << fixed << setprecision(1) << setw(11) << mean*1000
+                     << setprecision(0) << setw(13) << (double)size*size/mean
+                     << setprecision(1) << setw(10) << peakRssMb()
+                     << setprecision(1) << setw(10) << (double)stats.contradictions/repeats
+                     << setw(9) << (double)stats.wipes/repeats
+                     << setw(11) << (double)stats.wipedCells/repeats
+                     << setw(10) << (double)stats.restarts/repeats
+                     << setw(12) << (double)stats.backtracks/repeats << endl;
+                if(mean > budget) break;
+            }
+        }
+    }
+
+    // the time per phase of all cases, when built with WFC_STATS
+    profileDump();
+
+    return 0;
+}
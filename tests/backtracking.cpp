@@ -0,0 +1,108 @@
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "../wfc/Domain.h"
+#include "../wfc/Rules.h"
+#include "../wfc/Config.h"
+#include "../wfc/Random.h"
+#include "../wfc/Grid.h"
+#include "../wfc/WFCwithBacktracking.h"
+
+using namespace std;
+
+// Backtracking against exhaustive search - with random adjacency rules a grid has to be found exactly
+// when one exists, and it has to be valid, so backjumping can't jump over a branch that had a solution
+// usage: backtracking [rulesets seed], exits with 1 on the first wrong answer
+
+const int N = 5;
+const int M = 6;
+
+// 2 to 8 tiles, every pair fits side by side and on top of each other with its own chance
+Rules randomRules(Rng& gen){
+    int T = getRandom(gen,2,8);
+    int chance = getRandom(gen,25,50);
+    Rules rules;
+    rules.tileCount = T;
+    for(int d = 0; d < 4; d++) rules.compatible[d].assign(T,Domain());
+    for(int t = 0; t < T; t++){
+        rules.all.set(t);
+        for(int u = 0; u < T; u++){
+            // u right of t, then u below t
+            if(getRandom(gen,0,99) < chance){
+                rules.compatible[1][t].set(u);
+                rules.compatible[3][u].set(t);
+            }
+            if(getRandom(gen,0,99) < chance){
+                rules.compatible[2][t].set(u);
+                rules.compatible[0][u].set(t);
+            }
+        }
+    }
+    rules.weights.assign(T,1);
+    rules.weightLogs.assign(T,0);
+    return rules;
+}
+
+// fills the cells from i on in row major order, true if the grid can be completed
+bool exists(Rules& rules, vector<int>& grid, int i){
+    if(i == N*M) return true;
+    int x = i/M;
+    int y = i%M;
+    for(int t = 0; t < rules.tileCount; t++){
+        // the cell above and the one to the left are already filled
+        if(x > 0 && !rules.compatible[2][grid[i-M]].test(t)) continue;
+        if(y > 0 && !rules.compatible[1][grid[i-1]].test(t)) continue;
+        grid[i] = t;
+        if(exists(rules,grid,i+1)) return true;
+    }
+    return false;
+}
+bool valid(Rules& rules, Grid<int>& g){
+    for(int x = 0; x < N; x++){
+        for(int y = 0; y < M; y++){
+            if(g(x,y) < 0) return false;
+            if(y+1 < M && !rules.compatible[1][g(x,y)].test(g(x,y+1))) return false;
+            if(x+1 < N && !rules.compatible[2][g(x,y)].test(g(x+1,y))) return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv){
+    int rulesets = 5000;
+    uint64_t seed = 1;
+    if(argc >= 2) rulesets = atoi(argv[1]);
+    if(argc >= 3) seed = strtoull(argv[2],nullptr,10);
+    Rng gen(seed);
+
+    Config config;
+    config.n = N;
+    config.m = M;
+    int solvable = 0;
+    for(int k = 0; k < rulesets; k++){
+        Rules rules = randomRules(gen);
+        vector<int> grid(N*M);
+        bool expected = exists(rules,grid,0);
+        solvable += expected;
+
+        bool found = true;
+        Rng rng(hashKey(seed,k));
+        try{
+            Grid<int> g = WFCwithBacktracking(rules,config,rng);
+            if(!valid(rules,g)){
+                cout << "ruleset " << k << ": invalid grid" << endl;
+                return 1;
+            }
+        }catch(const runtime_error&){
+            found = false;
+        }
+        if(found != expected){
+            cout << "ruleset " << k << ": " << (expected ? "missed a solution" : "found a grid that can't exist") << endl;
+            return 1;
+        }
+    }
+    cout << rulesets << " rulesets, " << solvable << " solvable, all agree with exhaustive search" << endl;
+    return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <algorithm>
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "Grid.h"
+#include "ThreadPool.h"
+#include "WFCwithBBM.h"
+
+// Batches - many small grids of one tileset made with BBM in one call
+
+// makes count grids of config.n x config.m on config.threads threads
+// grid k is written to out + k*n*m as n rows of m tile indices, out must hold count*n*m ints
+// grid k is made with a generator keyed by k, so it only depends on the seed and k,
+// not on the amount of threads or which thread took it
+// every thread keeps its SolverContext from one grid to the next, after its first grid it doesn't allocate
+inline void WFCbatch(Rules& rules, Config& config, Rng& rng, int count, int* out){
+    uint64_t seed = rng();
+    int N = config.n;
+    int M = config.m;
+    ThreadPool pool(config.threads);
+    std::atomic<int> next(0);
+
+    int threads = std::min(pool.size(),count);
+    for(int i = 0; i < threads; i++){
+        pool.push([&]{
+            SolverContext ctx;
+            try{
+                while(true){
+                    int k = next++;
+                    if(k >= count) break;
+                    Rng mapRng(hashKey(seed,k));
+                    solveBBM(rules,config,mapRng,ctx);
+                    int* dst = out + (size_t)k*N*M;
+                    for(int x = 0; x < N; x++) std::copy_n(&ctx.res(x,0),M,dst+(size_t)x*M);
+                }
+            }catch(...){
+                next = count;
+                throw;
+            }
+        });
+    }
+    pool.wait();
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Stats.h"
+
+// parameters of a run, none of them need a recompile
+struct Config{
+    int n = 100;
+    int m = 100;
+    // BBM clears a (2*r+1)^2 block around a conflict, r starts at minBlockRadius and grows up to
+    // blockRadius where conflicts keep coming back, minBlockRadius = blockRadius always clears the same
+    int blockRadius = 5;
+    int minBlockRadius = 1;
+    // WFCchunked solves chunkSize x chunkSize chunks, at least 2*blockRadius+3 wide
+    int chunkSize = 64;
+    // worker threads, 0 - one per hardware thread
+    int threads = 0;
+    // counters of the run, nothing is counted if it's null
+    RunStats* stats = nullptr;
+
+    bool inBounds(int x, int y) const {
+        return x >= 0 && y >= 0 && x < n && y < m;
+    }
+};
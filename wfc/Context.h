@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+#include "Domain.h"
+#include "Grid.h"
+#include "IndexedHeap.h"
+#include "Frontier.h"
+#include "Propagator.h"
+#include "Repair.h"
+
+// a fixed cell on the decision stack of backtracking and the marks to undo it
+struct Decision{
+    int cell;
+    int tile;
+    size_t mark;
+    size_t borderMark;
+};
+
+// everything a solver allocates for a run, kept from one run to the next
+// a run only refills what it uses, and the queues and trails that grow during a run get room for a
+// usual run up front (pending bans, the frontier) or for the worst one (backtracking's trail), so
+// once a context has made a grid, the next one of the same size normally doesn't allocate, whether
+// it's a new map, a reset attempt or a chunk, only a run that queues more than the room it got does
+// a context is used by one run at a time
+struct SolverContext{
+    // the grid being filled, or the window of a region
+    Grid<int> res;
+    Propagator prop;
+    IndexedHeap<double> pq;
+    RepairRadius repair;
+
+    // backtracking
+    Frontier border;
+    std::vector<Decision> stack;
+
+    // plain WFC, its cells are queued in pq
+    Grid<Domain> possibilities;
+
+    // regions, pinned cells of the window and the empty ones left
+    std::vector<char> pinned;
+    std::vector<int> unfilled;
+};
+
+// contexts for the jobs of a thread pool, a job takes one and gives it back when it's done,
+// so there are never more of them than jobs running at once, and each is reused by the next job
+struct ContextPool{
+    std::vector<std::unique_ptr<SolverContext>> all;
+    std::vector<SolverContext*> idle;
+    std::mutex mtx;
+
+    SolverContext* take(){
+        std::lock_guard<std::mutex> lock(mtx);
+        if(idle.empty()){
+            all.push_back(std::unique_ptr<SolverContext>(new SolverContext()));
+            return all.back().get();
+        }
+        SolverContext* res = idle.back();
+        idle.pop_back();
+        return res;
+    }
+    void give(SolverContext* ctx){
+        std::lock_guard<std::mutex> lock(mtx);
+        idle.push_back(ctx);
+    }
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "Tile.h"
+#include "Kernels.h"
+#include "Grid.h"
+#include "Profile.h"
+
+// rendered text is collected into a buffer of about this many bytes before it's written out
+constexpr size_t RENDER_BUFFER = 1 << 20;
+
+// writes the size lines of chars of row x of the grid to dst, each ending in '\n',
+// every cell drawn as its tile, size*(size*m+1) bytes, disps[t] is the chars of tile t
+inline char* renderRow(const Grid<int>& generated, const char* const* disps, const TileKernels& kernels, int x, char* dst){
+    int m = generated.m;
+    int size = kernels.size;
+    const int* row = &generated(x,0);
+    for(int a = 0; a < size; a++){
+        kernels.drawLine(row,m,disps,a,dst,size);
+        dst += (size_t)size*m;
+        *dst++ = '\n';
+    }
+    return dst;
+}
+inline std::vector<const char*> tileChars(const std::vector<Tile>& tiles){
+    std::vector<const char*> res;
+    for(const Tile& t : tiles) res.push_back(t.disp.data());
+    return res;
+}
+
+// prints the generated grid, every cell drawn as its tile
+// rows are rendered straight into one buffer that's written out whenever it's full
+inline void displayGenerated(Grid<int>& generated, std::vector<Tile>& tiles, std::ostream& out = std::cout){
+    WFC_TIME(PHASE_RENDER);
+    int n = generated.n;
+    int m = generated.m;
+    int size = tiles[0].size;
+    TileKernels kernels = getTileKernels(size);
+    std::vector<const char*> disps = tileChars(tiles);
+
+    size_t rowBytes = (size_t)size*((size_t)size*m+1);
+    int rows = std::max<size_t>(RENDER_BUFFER/rowBytes,1);
+    std::vector<char> buf(rows*rowBytes);
+    for(int i = 0; i < n; i += rows){
+        char* end = buf.data();
+        for(int x = i; x < std::min(i+rows,n); x++) end = renderRow(generated,disps.data(),kernels,x,end);
+        out.write(buf.data(),end-buf.data());
+    }
+    out.flush();
+}
+// prints a grid of the overlapping model, every cell drawn as the top left char of its pattern
+inline void displayOverlapping(Grid<int>& generated, std::vector<Tile>& patterns, std::ostream& out = std::cout){
+    WFC_TIME(PHASE_RENDER);
+    int n = generated.n;
+    int m = generated.m;
+    int rows = std::max<size_t>(RENDER_BUFFER/(m+1),1);
+    std::vector<char> buf((size_t)rows*(m+1));
+    for(int i = 0; i < n; i += rows){
+        char* end = buf.data();
+        for(int x = i; x < std::min(i+rows,n); x++){
+            const int* row = &generated(x,0);
+            for(int j = 0; j < m; j++) *end++ = patterns[row[j]].disp[0];
+            *end++ = '\n';
+        }
+        out.write(buf.data(),end-buf.data());
+    }
+    out.flush();
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// max amount of tiles a tileset can have, raise with -DWFC_MAX_TILES=...
+#ifndef WFC_MAX_TILES
+#define WFC_MAX_TILES 256
+#endif
+
+inline int popcount64(uint64_t x){
+#ifdef _MSC_VER
+    return (int)__popcnt64(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+// index of the lowest set bit, x must not be 0
+inline int lowestBit64(uint64_t x){
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i,x);
+    return (int)i;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// set of tile indices stored as a fixed size bitset
+struct Domain{
+    static constexpr int WORDS = (WFC_MAX_TILES+63)/64;
+    uint64_t bits[WORDS];
+
+    Domain(){
+        clear();
+    }
+    void clear(){
+        for(int i = 0; i < WORDS; i++) bits[i] = 0;
+    }
+    // first n tiles
+    void fill(int n){
+        for(int i = 0; i < WORDS; i++){
+            if(n >= 64*(i+1)) bits[i] = ~uint64_t(0);
+            else if(n > 64*i) bits[i] = (uint64_t(1) << (n-64*i)) - 1;
+            else bits[i] = 0;
+        }
+    }
+    void set(int i){
+        bits[i>>6] |= uint64_t(1) << (i&63);
+    }
+    void reset(int i){
+        bits[i>>6] &= ~(uint64_t(1) << (i&63));
+    }
+    bool test(int i) const {
+        return (bits[i>>6] >> (i&63)) & 1;
+    }
+    int size() const {
+        int res = 0;
+        for(int i = 0; i < WORDS; i++) res += popcount64(bits[i]);
+        return res;
+    }
+    bool empty() const {
+        for(int i = 0; i < WORDS; i++) if(bits[i]) return false;
+        return true;
+    }
+    // k-th (0 based) tile of the set, -1 if the set is smaller
+    int nth(int k) const {
+        for(int i = 0; i < WORDS; i++){
+            int c = popcount64(bits[i]);
+            if(k >= c){
+                k -= c;
+                continue;
+            }
+            uint64_t w = bits[i];
+            for(int j = 0; j < k; j++) w &= w-1;
+            return i*64 + lowestBit64(w);
+        }
+        return -1;
+    }
+    // first tile after i, -1 if there is none, use next(-1) for the first tile
+    int next(int i) const {
+        i++;
+        int w = i>>6;
+        if(w >= WORDS) return -1;
+        uint64_t cur = bits[w] & (~uint64_t(0) << (i&63));
+        while(true){
+            if(cur) return w*64 + lowestBit64(cur);
+            if(++w == WORDS) return -1;
+            cur = bits[w];
+        }
+    }
+    Domain& operator&=(const Domain& a){
+        for(int i = 0; i < WORDS; i++) bits[i] &= a.bits[i];
+        return *this;
+    }
+    bool operator==(const Domain& a) const {
+        for(int i = 0; i < WORDS; i++) if(bits[i] != a.bits[i]) return false;
+        return true;
+    }
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "Domain.h"
+
+// cells waiting to be fixed, bucketed by the size of their domain, or Propagator::bucket() with weights
+// a bitmask of the non-empty buckets finds the smallest one in a few word scans,
+// and every change is journaled so a backtrack restores the frontier with undo(mark)
+//
+// each bucket is a min heap of cell indices, so ties go to the lowest cell and the grid
+// fills in scanline order, which keeps conflicts close to the decisions that caused them
+struct Frontier{
+    static constexpr int WORDS = (WFC_MAX_TILES+1+63)/64;
+
+    std::vector<std::vector<int>> buckets;
+    // bucket of a cell, -1 if it isn't in the frontier
+    std::vector<int> sizeOf;
+    // place of a cell in its bucket's heap
+    std::vector<int> pos;
+    uint64_t nonEmpty[WORDS];
+    int count = 0;
+
+    // (cell, previous size) for every change
+    std::vector<std::pair<int,int>> trail;
+
+    // bucketRoom - cells every bucket has room for from the start, buckets also keep their room from the last run
+    void init(int cells, int maxSize, int bucketRoom = 0){
+        buckets.resize(maxSize+1);
+        for(std::vector<int>& b : buckets){
+            b.clear();
+            b.reserve(bucketRoom);
+        }
+        sizeOf.assign(cells,-1);
+        pos.assign(cells,-1);
+        for(int i = 0; i < WORDS; i++) nonEmpty[i] = 0;
+        count = 0;
+        trail.clear();
+        // a cell is added, moves a few buckets and is taken out, about 3 entries per cell in a full run
+        trail.reserve((size_t)4*cells);
+    }
+    bool empty() const {
+        return count == 0;
+    }
+    bool contains(int cell) const {
+        return sizeOf[cell] != -1;
+    }
+    // a cell from the smallest bucket
+    int top() const {
+        for(int i = 0; i < WORDS; i++){
+            if(nonEmpty[i]) return buckets[i*64 + lowestBit64(nonEmpty[i])][0];
+        }
+        return -1;
+    }
+    // inserts the cell or moves it to a new size
+    void set(int cell, int size){
+        if(sizeOf[cell] == size) return;
+        trail.push_back({cell,sizeOf[cell]});
+        place(cell,size);
+    }
+    void erase(int cell){
+        if(sizeOf[cell] == -1) return;
+        trail.push_back({cell,sizeOf[cell]});
+        place(cell,-1);
+    }
+
+    size_t mark() const {
+        return trail.size();
+    }
+    void undo(size_t mark){
+        while(trail.size() > mark){
+            place(trail.back().first,trail.back().second);
+            trail.pop_back();
+        }
+    }
+
+    // moves a cell without journaling, size -1 removes it
+    void place(int cell, int size){
+        int old = sizeOf[cell];
+        if(old != -1){
+            std::vector<int>& b = buckets[old];
+            int i = pos[cell];
+            int last = b.back();
+            b.pop_back();
+            if(last != cell){
+                b[i] = last;
+                pos[last] = i;
+                siftUp(b,i);
+                siftDown(b,pos[last]);
+            }
+            if(b.empty()) nonEmpty[old>>6] &= ~(uint64_t(1) << (old&63));
+            count--;
+        }
+        sizeOf[cell] = size;
+        if(size != -1){
+            std::vector<int>& b = buckets[size];
+            pos[cell] = b.size();
+            b.push_back(cell);
+            siftUp(b,pos[cell]);
+            nonEmpty[size>>6] |= uint64_t(1) << (size&63);
+            count++;
+        }
+    }
+    void siftUp(std::vector<int>& b, int i){
+        int cell = b[i];
+        while(i > 0){
+            int p = (i-1)/2;
+            if(b[p] < cell) break;
+            b[i] = b[p];
+            pos[b[i]] = i;
+            i = p;
+        }
+        b[i] = cell;
+        pos[cell] = i;
+    }
+    void siftDown(std::vector<int>& b, int i){
+        int cell = b[i];
+        int n = b.size();
+        while(true){
+            int c = 2*i+1;
+            if(c >= n) break;
+            if(c+1 < n && b[c+1] < b[c]) c++;
+            if(cell < b[c]) break;
+            b[i] = b[c];
+            pos[b[i]] = i;
+            i = c;
+        }
+        b[i] = cell;
+        pos[cell] = i;
+    }
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// value of the padding around an output grid, so "res[cell] == -1" is false outside the grid
+constexpr int OUTSIDE = -2;
+
+// n x m grid in one row-major allocation, surrounded by pad cells on every side
+//
+// with pad >= 1 the neighbour in direction d of a cell is cell+delta[d], the padding is
+// filled with padValue, so loops over neighbours don't need bounds checks
+template<class T>
+struct Grid{
+    int n = 0;
+    int m = 0;
+    int pad = 0;
+    int stride = 0;
+    int delta[4] = {0,0,0,0};
+    std::vector<T> data;
+
+    Grid(){}
+    Grid(int _n, int _m, T value, int _pad = 0, T padValue = T()){
+        assign(_n,_m,value,_pad,padValue);
+    }
+    void assign(int _n, int _m, T value, int _pad = 0, T padValue = T()){
+        n = _n;
+        m = _m;
+        pad = _pad;
+        stride = m+2*pad;
+        delta[0] = -stride;
+        delta[1] = 1;
+        delta[2] = stride;
+        delta[3] = -1;
+        data.assign((size_t)(n+2*pad)*stride, padValue);
+        for(int x = 0; x < n; x++){
+            for(int y = 0; y < m; y++) data[index(x,y)] = value;
+        }
+    }
+
+    // cells including the padding, every index is below it
+    int cells() const {
+        return data.size();
+    }
+    int index(int x, int y) const {
+        return (x+pad)*stride + y+pad;
+    }
+    int getX(int cell) const {
+        return cell/stride - pad;
+    }
+    int getY(int cell) const {
+        return cell%stride - pad;
+    }
+    bool isInside(int cell) const {
+        int x = getX(cell);
+        int y = getY(cell);
+        return x >= 0 && y >= 0 && x < n && y < m;
+    }
+    T& operator()(int x, int y){
+        return data[index(x,y)];
+    }
+    const T& operator()(int x, int y) const {
+        return data[index(x,y)];
+    }
+    T& operator[](int cell){
+        return data[cell];
+    }
+    const T& operator[](int cell) const {
+        return data[cell];
+    }
+};
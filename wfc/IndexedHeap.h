@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+
+// binary min heap of cell indices, every cell is in it at most once
+// pos[cell] is the place of the cell in the heap (-1 if it isn't there), so the key
+// of a cell can be changed in place instead of pushing it again
+template<class Key>
+struct IndexedHeap{
+    std::vector<int> heap;
+    std::vector<int> pos;
+    std::vector<Key> keys;
+
+    // a heap that already has room for the cells is only emptied, keys of cells outside it are never read
+    void init(int cells){
+        if((int)pos.size() == cells){
+            clear();
+            return;
+        }
+        heap.clear();
+        heap.reserve(cells);
+        pos.assign(cells,-1);
+        keys.assign(cells,Key());
+    }
+    bool empty() const {
+        return heap.empty();
+    }
+    int size() const {
+        return heap.size();
+    }
+    bool contains(int cell) const {
+        return pos[cell] != -1;
+    }
+    int top() const {
+        return heap[0];
+    }
+    // inserts the cell or moves it to its new key
+    void push(int cell, Key key){
+        keys[cell] = key;
+        if(pos[cell] == -1){
+            pos[cell] = heap.size();
+            heap.push_back(cell);
+            siftUp(pos[cell]);
+        }else{
+            siftUp(pos[cell]);
+            siftDown(pos[cell]);
+        }
+    }
+    int pop(){
+        int cell = heap[0];
+        erase(cell);
+        return cell;
+    }
+    void erase(int cell){
+        int i = pos[cell];
+        if(i == -1) return;
+        int last = heap.back();
+        heap.pop_back();
+        pos[cell] = -1;
+        if(last == cell) return;
+        heap[i] = last;
+        pos[last] = i;
+        siftUp(i);
+        siftDown(pos[last]);
+    }
+    void clear(){
+        for(int cell : heap) pos[cell] = -1;
+        heap.clear();
+    }
+
+    void siftUp(int i){
+        int cell = heap[i];
+        while(i > 0){
+            int p = (i-1)/2;
+            if(!(keys[cell] < keys[heap[p]])) break;
+            heap[i] = heap[p];
+            pos[heap[i]] = i;
+            i = p;
+        }
+        heap[i] = cell;
+        pos[cell] = i;
+    }
+    void siftDown(int i){
+        int cell = heap[i];
+        int n = heap.size();
+        while(true){
+            int c = 2*i+1;
+            if(c >= n) break;
+            if(c+1 < n && keys[heap[c+1]] < keys[heap[c]]) c++;
+            if(!(keys[heap[c]] < keys[cell])) break;
+            heap[i] = heap[c];
+            pos[heap[i]] = i;
+            i = c;
+        }
+        heap[i] = cell;
+        pos[cell] = i;
+    }
+};
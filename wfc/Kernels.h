@@ -0,0 +1,58 @@
+#pragma once
+#include <stdexcept>
+
+// small loops over a tile, tile sizes 2 to 5 are compiled with the size as a constant,
+// so the loops are fully unrolled, other sizes fall back to the runtime versions
+//
+// sides are read clockwise: top left to right, right top to bottom,
+// bottom right to left, left bottom to top
+
+template<int S>
+void readSocketsFixed(const char* disp, char* sockets, int){
+    for(int i = 0; i < S; i++) sockets[i+S*0] = disp[i];
+    for(int i = 0; i < S; i++) sockets[i+S*1] = disp[i*S+S-1];
+    for(int i = 0; i < S; i++) sockets[i+S*2] = disp[(S-1)*S+S-1-i];
+    for(int i = 0; i < S; i++) sockets[i+S*3] = disp[(S-1-i)*S];
+}
+inline void readSocketsAny(const char* disp, char* sockets, int s){
+    for(int i = 0; i < s; i++) sockets[i+s*0] = disp[i];
+    for(int i = 0; i < s; i++) sockets[i+s*1] = disp[i*s+s-1];
+    for(int i = 0; i < s; i++) sockets[i+s*2] = disp[(s-1)*s+s-1-i];
+    for(int i = 0; i < s; i++) sockets[i+s*3] = disp[(s-1-i)*s];
+}
+
+// line a of a row of cells, disps[t] is the chars of tile t
+template<int S>
+void drawLineFixed(const int* row, int m, const char* const* disps, int a, char* dst, int){
+    for(int j = 0; j < m; j++){
+        const char* src = disps[row[j]]+a*S;
+        for(int i = 0; i < S; i++) dst[j*S+i] = src[i];
+    }
+}
+inline void drawLineAny(const int* row, int m, const char* const* disps, int a, char* dst, int s){
+    for(int j = 0; j < m; j++){
+        const char* src = disps[row[j]]+a*s;
+        for(int i = 0; i < s; i++) dst[j*s+i] = src[i];
+    }
+}
+
+struct TileKernels{
+    int size;
+    void (*readSockets)(const char* disp, char* sockets, int size);
+    void (*drawLine)(const int* row, int m, const char* const* disps, int a, char* dst, int size);
+};
+
+template<int S>
+TileKernels getFixedKernels(){
+    return {S, readSocketsFixed<S>, drawLineFixed<S>};
+}
+inline TileKernels getTileKernels(int size){
+    if(size <= 0) throw std::invalid_argument("tile size must be positive");
+    switch(size){
+        case 2: return getFixedKernels<2>();
+        case 3: return getFixedKernels<3>();
+        case 4: return getFixedKernels<4>();
+        case 5: return getFixedKernels<5>();
+    }
+    return {size, readSocketsAny, drawLineAny};
+}
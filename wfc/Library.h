@@ -0,0 +1,41 @@
+#pragma once
+
+// everything needed to generate a grid
+//
+//  std::vector<Tile> tiles = {...};
+//  Rules rules = compileRules(tiles,emptyChar);
+//  or from a file: Tileset set; Rules rules = loadTileset("tilesets/pipe.tiles",set);
+//  Config config;
+//  config.n = 200; config.m = 100;
+//  Grid<int> generated = WFCwithBBM(rules,config,rng);
+//  displayGenerated(generated,tiles);
+//  regenerate(rules,config,rng,generated,{{10,20,tile}},5,15,15,25);
+//  many grids one after another: SolverContext ctx; solveBBM(rules,config,rng,ctx); ctx.res is the grid
+
+#include "Domain.h"
+#include "Kernels.h"
+#include "Sockets.h"
+#include "Tile.h"
+#include "Rules.h"
+#include "Patterns.h"
+#include "TilesetFile.h"
+#include "Config.h"
+#include "Grid.h"
+#include "Random.h"
+#include "IndexedHeap.h"
+#include "Frontier.h"
+#include "Propagator.h"
+#include "Context.h"
+#include "ThreadPool.h"
+#include "Profile.h"
+#include "Display.h"
+#include "Output.h"
+#include "WFC.h"
+#include "WFCwithBBM.h"
+#include "WFCwithReset.h"
+#include "WFCwithBacktracking.h"
+#include "WFCchunked.h"
+#include "WFCstream.h"
+#include "Batch.h"
+#include "Mapped.h"
+#include "Regenerate.h"
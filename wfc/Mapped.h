@@ -0,0 +1,92 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include "MappedFile.h"
+#include "Tile.h"
+#include "Kernels.h"
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "Grid.h"
+#include "Display.h"
+#include "Output.h"
+#include "WFCstream.h"
+
+// Memory mapped output - a grid written straight into a file that the system pages out on its own,
+// so a grid can be bigger than the memory, and other programs can map the file without reading it
+
+// a grid in a mapped tile index file (see Output.h), the tile indices and, if the file has one,
+// the drawn grid after them, size*n lines of size*m chars ended by '\n', like displayGenerated prints
+struct MappedGrid{
+    MappedFile file;
+    TileFileHeader header;
+    char* cells = nullptr;
+    char* raster = nullptr;
+    // chars of a line of the drawn grid, '\n' included
+    size_t lineBytes = 0;
+    std::vector<const char*> disps;
+    TileKernels kernels;
+
+    // makes an n x m grid of tiles at path, every cell 0, with room for the drawn grid if draw is set
+    void create(const std::string& path, int n, int m, const std::vector<Tile>& tiles, bool draw = true){
+        int size = tiles[0].size;
+        header = makeTileHeader(n,m,tiles.size(),draw ? size : 0);
+        lineBytes = draw ? (size_t)size*m+1 : 0;
+        size_t cellBytes = (size_t)n*m*header.bytes;
+        file.create(path, TILE_FILE_HEADER + cellBytes + (size_t)size*n*lineBytes);
+        putTileHeader(file.data,header);
+        cells = file.data+TILE_FILE_HEADER;
+        raster = draw ? cells+cellBytes : nullptr;
+        disps = tileChars(tiles);
+        kernels = getTileKernels(size);
+    }
+    // maps a grid that was made before for reading
+    void open(const std::string& path){
+        file.open(path);
+        if(file.size < (size_t)TILE_FILE_HEADER) throw std::runtime_error("not a tile index file");
+        header = getTileHeader(file.data);
+        size_t cellBytes = (size_t)header.n*header.m*header.bytes;
+        lineBytes = header.tileSize ? (size_t)header.tileSize*header.m+1 : 0;
+        if(file.size < TILE_FILE_HEADER + cellBytes + (size_t)header.tileSize*header.n*lineBytes) throw std::runtime_error("tile index file is cut short");
+        cells = file.data+TILE_FILE_HEADER;
+        raster = header.tileSize ? cells+cellBytes : nullptr;
+        disps.clear();
+    }
+
+    int at(long long x, int y) const {
+        return getLE(cells + ((size_t)x*header.m+y)*header.bytes, header.bytes);
+    }
+    void set(long long x, int y, int tile){
+        putLE(cells + ((size_t)x*header.m+y)*header.bytes, tile, header.bytes);
+    }
+    // line i of the drawn grid, lineBytes chars
+    const char* line(long long i) const {
+        return raster + (size_t)i*lineBytes;
+    }
+
+    // rows [0,rows) of g become rows firstRow.. of the file, drawn straight into the raster
+    void writeRows(const Grid<int>& g, long long firstRow, int rows){
+        WFC_TIME(PHASE_RENDER);
+        for(int x = 0; x < rows; x++){
+            const int* row = &g(x,0);
+            char* dst = cells + (size_t)(firstRow+x)*header.m*header.bytes;
+            for(int y = 0; y < header.m; y++, dst += header.bytes) putLE(dst,row[y],header.bytes);
+            if(raster) renderRow(g,disps.data(),kernels,x,raster + (size_t)(firstRow+x)*header.tileSize*lineBytes);
+        }
+    }
+};
+
+// fills a created MappedGrid with WFCstream, band after band, config.m is taken from the grid
+// only two bands are in memory, the rest of the grid lives in the file
+inline void WFCmapped(Rules& rules, Config& config, Rng& rng, MappedGrid& out){
+    long long n = out.header.n;
+    config.m = out.header.m;
+    long long bands = (n+config.chunkSize-1)/config.chunkSize;
+    WFCstream(rules,config,rng,[&](Grid<int>& band, long long firstRow){
+        out.writeRows(band,firstRow,std::min<long long>(band.n,n-firstRow));
+        return true;
+    },bands);
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <stdexcept>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// a whole file mapped into memory
+struct MappedFile{
+    char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile(){
+        close();
+    }
+
+    // makes the file size bytes long, replacing what was there, and maps it for writing
+    void create(const std::string& path, size_t _size){
+        map(path,_size,true);
+    }
+    // maps an existing file for reading
+    void open(const std::string& path){
+        map(path,0,false);
+    }
+    // writes the changed pages to the disk now instead of whenever the system wants to
+    void flush(){
+        if(!data) return;
+#ifdef _WIN32
+        FlushViewOfFile(data,0);
+#else
+        msync(data,size,MS_SYNC);
+#endif
+    }
+    void close(){
+#ifdef _WIN32
+        if(data) UnmapViewOfFile(data);
+        if(mapping) CloseHandle(mapping);
+        if(file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if(data) munmap(data,size);
+        if(fd != -1) ::close(fd);
+        fd = -1;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    void map(const std::string& path, size_t _size, bool write){
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), write ? GENERIC_READ|GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           write ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE) throw std::runtime_error("can't open " + path);
+        LARGE_INTEGER len;
+        if(write){
+            len.QuadPart = _size;
+            if(!SetFilePointerEx(file,len,nullptr,FILE_BEGIN) || !SetEndOfFile(file)) fail(path);
+        }else if(!GetFileSizeEx(file,&len)) fail(path);
+        size = len.QuadPart;
+        if(size == 0) fail(path);
+        mapping = CreateFileMappingA(file, nullptr, write ? PAGE_READWRITE : PAGE_READONLY, len.HighPart, len.LowPart, nullptr);
+        if(!mapping) fail(path);
+        data = (char*)MapViewOfFile(mapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        if(!data) fail(path);
+#else
+        fd = ::open(path.c_str(), write ? O_RDWR|O_CREAT|O_TRUNC : O_RDONLY, 0644);
+        if(fd == -1) throw std::runtime_error("can't open " + path);
+        if(write){
+            if(ftruncate(fd,_size) != 0) fail(path);
+            size = _size;
+        }else{
+            struct stat st;
+            if(fstat(fd,&st) != 0) fail(path);
+            size = st.st_size;
+        }
+        if(size == 0) fail(path);
+        void* p = mmap(nullptr, size, write ? PROT_READ|PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if(p == MAP_FAILED) fail(path);
+        data = (char*)p;
+#endif
+    }
+    void fail(const std::string& path){
+        close();
+        throw std::runtime_error("can't map " + path);
+    }
+};
@@ -0,0 +1,194 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "Tile.h"
+#include "Kernels.h"
+#include "Grid.h"
+#include "Profile.h"
+#include "Display.h"
+
+// Output formats besides text - the tile indices as a binary file, and the drawn grid as an image
+
+// tile index file, little endian:
+//   "WFCG", u8 version 1, u8 bytes per cell (1 below 257 tiles, else 2), u16 tile size of the drawn grid
+//   after the indices (0 - none), u32 n, u32 m, u32 tileCount, then the n*m tile indices row by row,
+//   then if the tile size isn't 0, size*n lines of size*m chars ended by '\n' (see Mapped.h)
+constexpr char TILE_FILE_MAGIC[4] = {'W','F','C','G'};
+constexpr int TILE_FILE_HEADER = 20;
+
+struct TileFileHeader{
+    int bytes;
+    int tileSize;
+    int n;
+    int m;
+    int tileCount;
+};
+
+inline void putLE(char* dst, uint32_t v, int bytes){
+    for(int i = 0; i < bytes; i++) dst[i] = (char)(v >> (8*i));
+}
+inline uint32_t getLE(const char* src, int bytes){
+    uint32_t v = 0;
+    for(int i = 0; i < bytes; i++) v |= (uint32_t)(unsigned char)src[i] << (8*i);
+    return v;
+}
+
+inline TileFileHeader makeTileHeader(int n, int m, int tileCount, int tileSize = 0){
+    if(tileCount > 65536) throw std::length_error("tile index files hold at most 65536 tiles");
+    return {tileCount <= 256 ? 1 : 2, tileSize, n, m, tileCount};
+}
+inline void putTileHeader(char* dst, const TileFileHeader& h){
+    for(int i = 0; i < 4; i++) dst[i] = TILE_FILE_MAGIC[i];
+    dst[4] = 1;
+    dst[5] = h.bytes;
+    putLE(dst+6,h.tileSize,2);
+    putLE(dst+8,h.n,4);
+    putLE(dst+12,h.m,4);
+    putLE(dst+16,h.tileCount,4);
+}
+inline TileFileHeader getTileHeader(const char* src){
+    if(std::string(src,4) != std::string(TILE_FILE_MAGIC,4)) throw std::runtime_error("not a tile index file");
+    TileFileHeader h;
+    h.bytes = src[5];
+    if(src[4] != 1 || (h.bytes != 1 && h.bytes != 2)) throw std::runtime_error("unknown tile index file version");
+    h.tileSize = getLE(src+6,2);
+    h.n = getLE(src+8,4);
+    h.m = getLE(src+12,4);
+    h.tileCount = getLE(src+16,4);
+    return h;
+}
+
+inline void writeTileIndices(const Grid<int>& generated, int tileCount, std::ostream& out){
+    WFC_TIME(PHASE_RENDER);
+    int n = generated.n;
+    int m = generated.m;
+    TileFileHeader h = makeTileHeader(n,m,tileCount);
+    int bytes = h.bytes;
+    char header[TILE_FILE_HEADER];
+    putTileHeader(header,h);
+    out.write(header,TILE_FILE_HEADER);
+
+    int rows = std::max<size_t>(RENDER_BUFFER/((size_t)m*bytes),1);
+    std::vector<char> buf((size_t)rows*m*bytes);
+    for(int i = 0; i < n; i += rows){
+        char* end = buf.data();
+        for(int x = i; x < std::min(i+rows,n); x++){
+            const int* row = &generated(x,0);
+            for(int j = 0; j < m; j++, end += bytes) putLE(end,row[j],bytes);
+        }
+        out.write(buf.data(),end-buf.data());
+    }
+    out.flush();
+}
+// reads the tile indices of a file written by writeTileIndices or a MappedGrid, padded like the generated grids
+inline Grid<int> readTileIndices(std::istream& in){
+    char header[TILE_FILE_HEADER];
+    if(!in.read(header,TILE_FILE_HEADER)) throw std::runtime_error("not a tile index file");
+    TileFileHeader h = getTileHeader(header);
+    int bytes = h.bytes;
+    int n = h.n;
+    int m = h.m;
+    Grid<int> res(n,m,-1,1,OUTSIDE);
+    std::vector<char> row((size_t)m*bytes);
+    for(int x = 0; x < n; x++){
+        if(!in.read(row.data(),row.size())) throw std::runtime_error("tile index file is cut short");
+        for(int y = 0; y < m; y++) res(x,y) = getLE(&row[(size_t)y*bytes],bytes);
+    }
+    return res;
+}
+
+// colour of every char a tile can be drawn with
+struct Palette{
+    unsigned char rgb[256][3] = {};
+};
+// the chars of the tiles in order of first appearance, the first one black and the rest
+// spread over the gray levels up to white, or with colour over evenly spaced hues
+inline Palette makePalette(const std::vector<Tile>& tiles, bool colour = false){
+    std::vector<unsigned char> chars;
+    std::vector<char> seen(256,0);
+    for(const Tile& t : tiles){
+        for(char c : t.disp){
+            if(!seen[(unsigned char)c]++) chars.push_back(c);
+        }
+    }
+    Palette res;
+    int k = chars.size();
+    for(int i = 1; i < k; i++){
+        unsigned char* px = res.rgb[chars[i]];
+        if(!colour){
+            px[0] = px[1] = px[2] = 255*i/(k-1);
+            continue;
+        }
+        // hue to rgb at full saturation and value
+        double h = 6.0*(i-1)/(k-1);
+        double f = h-std::floor(h);
+        unsigned char up = 255*f, down = 255*(1-f);
+        const unsigned char rgb[6][3] = {{255,up,0},{down,255,0},{0,255,up},{0,down,255},{up,0,255},{255,0,down}};
+        for(int c = 0; c < 3; c++) px[c] = rgb[(int)h%6][c];
+    }
+    return res;
+}
+
+// binary PGM (channels 1) or PPM (channels 3) of the drawn grid, one pixel per char of a tile
+inline void writeImage(const Grid<int>& generated, const std::vector<Tile>& tiles, const Palette& palette, int channels, std::ostream& out){
+    WFC_TIME(PHASE_RENDER);
+    int n = generated.n;
+    int m = generated.m;
+    int size = tiles[0].size;
+    TileKernels kernels = getTileKernels(size);
+    std::vector<const char*> disps = tileChars(tiles);
+    out << (channels == 1 ? "P5" : "P6") << '\n' << (size_t)size*m << ' ' << (size_t)size*n << "\n255\n";
+
+    // gray is the luminance of the colour
+    unsigned char gray[256];
+    for(int c = 0; c < 256; c++){
+        const unsigned char* px = palette.rgb[c];
+        gray[c] = (px[0]*299 + px[1]*587 + px[2]*114 + 500)/1000;
+    }
+    size_t lineChars = (size_t)size*m+1;
+    std::vector<char> text(size*lineChars);
+    std::vector<unsigned char> pixels((size_t)size*(lineChars-1)*channels);
+    for(int x = 0; x < n; x++){
+        renderRow(generated,disps.data(),kernels,x,text.data());
+        unsigned char* dst = pixels.data();
+        for(int a = 0; a < size; a++){
+            const char* line = &text[a*lineChars];
+            for(size_t j = 0; j+1 < lineChars; j++){
+                unsigned char c = line[j];
+                if(channels == 1) *dst++ = gray[c];
+                else{
+                    *dst++ = palette.rgb[c][0];
+                    *dst++ = palette.rgb[c][1];
+                    *dst++ = palette.rgb[c][2];
+                }
+            }
+        }
+        out.write((const char*)pixels.data(),pixels.size());
+    }
+    out.flush();
+}
+inline void writePGM(const Grid<int>& generated, const std::vector<Tile>& tiles, const Palette& palette, std::ostream& out){
+    writeImage(generated,tiles,palette,1,out);
+}
+inline void writePPM(const Grid<int>& generated, const std::vector<Tile>& tiles, const Palette& palette, std::ostream& out){
+    writeImage(generated,tiles,palette,3,out);
+}
+
+// writes the grid to a file, the format is chosen by the extension: .wfcg - tile indices,
+// .pgm - gray image, .ppm - colour image, anything else - the text displayGenerated prints
+inline void writeOutputFile(const std::string& path, Grid<int>& generated, std::vector<Tile>& tiles){
+    std::ofstream file(path, std::ios::binary);
+    if(!file) throw std::runtime_error("can't open " + path);
+    std::string ext = path.substr(std::min(path.rfind('.'),path.size()));
+    if(ext == ".wfcg") writeTileIndices(generated,tiles.size(),file);
+    else if(ext == ".pgm") writePGM(generated,tiles,makePalette(tiles),file);
+    else if(ext == ".ppm") writePPM(generated,tiles,makePalette(tiles,true),file);
+    else displayGenerated(generated,tiles,file);
+    if(!file) throw std::runtime_error("can't write " + path);
+}
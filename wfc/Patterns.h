@@ -0,0 +1,183 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <stdexcept>
+#include "Domain.h"
+#include "Tile.h"
+#include "Rules.h"
+
+// Overlapping model - the tiles are the size x size patterns of a sample image, and two patterns
+// can be neighbours when they agree on everything they overlap when shifted by one cell
+
+// the distinct patterns of a sample and how often each was seen, the weight of a pattern
+struct Patterns{
+    std::vector<Tile> tiles;
+    std::vector<long long> counts;
+};
+
+// every size x size window of the image, dihedral variants included, each distinct one once
+// symmetry - how many variants of a window are added: 1 - only the window, 2 - and its mirror,
+// 4 - its rotations, 8 - rotations and mirrors
+// periodic - windows wrap around the edges of the image
+// windows are found through a rolling hash, so a sample is read in time linear in its size
+// with only size rows of hashes kept, and only windows not seen before become tiles
+inline Patterns extractPatterns(const std::vector<std::string>& image, int size, int symmetry = 1, bool periodic = false){
+    if(size <= 0) throw std::invalid_argument("pattern size must be positive");
+    if(symmetry != 1 && symmetry != 2 && symmetry != 4 && symmetry != 8) throw std::invalid_argument("symmetry must be 1, 2, 4 or 8");
+    int h = image.size();
+    int w = h ? image[0].size() : 0;
+    for(const std::string& row : image){
+        if((int)row.size() != w) throw std::invalid_argument("rows of the image must have the same length");
+    }
+    if(h < size || w < size) throw std::invalid_argument("image is smaller than a pattern");
+    int rows = periodic ? h : h-size+1;
+    int cols = periodic ? w : w-size+1;
+    // a periodic image gets its first size-1 rows and columns again after its end,
+    // so no window has to wrap
+    std::vector<std::string> wrapped;
+    if(periodic){
+        wrapped.resize(h+size-1);
+        for(int i = 0; i < h+size-1; i++) wrapped[i] = image[i%h] + image[i%h].substr(0,size-1);
+    }
+    const std::vector<std::string>& img = periodic ? wrapped : image;
+    auto at = [&](int i, int j) -> char {
+        return img[i][j];
+    };
+
+    // a distinct window, where it was seen first
+    struct Window{
+        int i;
+        int j;
+        long long count;
+        // next window with the same hash
+        int next;
+    };
+    std::vector<Window> windows;
+    std::unordered_map<uint64_t,int> first;
+    auto same = [&](const Window& a, int i, int j){
+        for(int x = 0; x < size; x++){
+            for(int y = 0; y < size; y++){
+                if(at(a.i+x,a.j+y) != at(i+x,j+y)) return false;
+            }
+        }
+        return true;
+    };
+
+    // a window's hash is the hash of the hashes of its size wide runs, both rolled,
+    // along a row for the runs and down the rows for the windows
+    const uint64_t B1 = 0x100000001b3ULL;
+    const uint64_t B2 = 0x9e3779b97f4a7c15ULL;
+    uint64_t pow1 = 1, pow2 = 1;
+    for(int k = 0; k < size; k++){
+        pow1 *= B1;
+        pow2 *= B2;
+    }
+    // runs of the last size rows, row i at i%size
+    std::vector<uint64_t> runs((size_t)size*cols);
+    std::vector<uint64_t> row(cols);
+    std::vector<uint64_t> window(cols,0);
+    for(int i = 0; i < rows+size-1; i++){
+        uint64_t cur = 0;
+        for(int j = 0; j < size; j++) cur = cur*B1 + (unsigned char)at(i,j);
+        row[0] = cur;
+        for(int j = 1; j < cols; j++){
+            cur = cur*B1 + (unsigned char)at(i,j+size-1) - pow1*(unsigned char)at(i,j-1);
+            row[j] = cur;
+        }
+        uint64_t* old = &runs[(size_t)(i%size)*cols];
+        for(int j = 0; j < cols; j++){
+            window[j] = window[j]*B2 + row[j] - (i >= size ? pow2*old[j] : 0);
+            old[j] = row[j];
+        }
+        if(i < size-1) continue;
+
+        // windows with the same hash are checked char by char
+        int top = i-size+1;
+        for(int j = 0; j < cols; j++){
+            auto it = first.find(window[j]);
+            int k = it == first.end() ? -1 : it->second;
+            while(k != -1 && !same(windows[k],top,j)) k = windows[k].next;
+            if(k != -1){
+                windows[k].count++;
+                continue;
+            }
+            windows.push_back({top,j,1,it == first.end() ? -1 : it->second});
+            first[window[j]] = windows.size()-1;
+        }
+    }
+
+    // the variants of the distinct windows, merged once more since a variant can be another window
+    Patterns res;
+    std::unordered_map<std::string,int> ids;
+    for(const Window& win : windows){
+        std::string s(size*size,' ');
+        for(int x = 0; x < size; x++){
+            for(int y = 0; y < size; y++) s[x*size+y] = at(win.i+x,win.j+y);
+        }
+        for(const Tile& cur : getVariants(Tile(s),symmetry)){
+            auto found = ids.find(cur.disp);
+            if(found == ids.end()){
+                ids[cur.disp] = res.tiles.size();
+                res.tiles.push_back(cur);
+                res.counts.push_back(win.count);
+            }else res.counts[found->second] += win.count;
+        }
+    }
+    return res;
+}
+
+// rules of the overlapping model, the socket of side d of a pattern is the part of it that the
+// neighbour in direction d overlaps, so neighbours fit when their sockets are the same
+// every pattern is weighted by how often it was seen
+inline Rules compileOverlapRules(const Patterns& patterns){
+    const std::vector<Tile>& tiles = patterns.tiles;
+    if(tiles.empty()) throw std::invalid_argument("tileset is empty");
+    if(tiles.size() > WFC_MAX_TILES) throw std::length_error("tileset has more than WFC_MAX_TILES tiles");
+
+    Rules rules;
+    rules.tileCount = tiles.size();
+    rules.tileSize = tiles[0].size;
+    int s = rules.tileSize;
+    for(const Tile& t : tiles){
+        if(t.size != s) throw std::invalid_argument("tiles of a tileset must have the same size");
+    }
+
+    // the rows or columns a neighbour in each direction shares, the first or the last size-1 of them
+    const int rowFrom[4] = {0,0,1,0};
+    const int colFrom[4] = {0,1,0,0};
+    const int rowCount[4] = {s-1,s,s-1,s};
+    const int colCount[4] = {s,s-1,s,s-1};
+    int T = rules.tileCount;
+    std::unordered_map<std::string,int> ids;
+    for(int d = 0; d < 4; d++){
+        rules.sockets[d].resize(T);
+        for(int t = 0; t < T; t++){
+            std::string part;
+            for(int i = rowFrom[d]; i < rowFrom[d]+rowCount[d]; i++){
+                for(int j = colFrom[d]; j < colFrom[d]+colCount[d]; j++) part += tiles[t].at(i,j);
+            }
+            // up and down parts are rows and left and right ones columns, keep them apart
+            part += d%2 ? '|' : '-';
+            auto it = ids.insert({part,(int)ids.size()}).first;
+            rules.sockets[d][t] = it->second;
+        }
+    }
+    rules.socketCount = ids.size();
+
+    // patterns that share a socket id fit, so each direction is filled through a list per socket
+    std::vector<Domain> withSocket(rules.socketCount);
+    for(int d = 0; d < 4; d++){
+        for(Domain& dom : withSocket) dom = Domain();
+        for(int u = 0; u < T; u++) withSocket[rules.sockets[(d+2)%4][u]].set(u);
+        rules.compatible[d].assign(T, Domain());
+        for(int t = 0; t < T; t++) rules.compatible[d][t] = withSocket[rules.sockets[d][t]];
+    }
+    for(int t = 0; t < T; t++) rules.all.set(t);
+    rules.weights.assign(T,1);
+    rules.weightLogs.assign(T,0);
+    if((int)patterns.counts.size() == T) setWeights(rules,std::vector<double>(patterns.counts.begin(),patterns.counts.end()));
+
+    return rules;
+}
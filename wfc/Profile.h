@@ -0,0 +1,176 @@
+#pragma once
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include "Stats.h"
+
+// time spent in each phase of the solvers, only compiled in with WFC_STATS defined
+//
+// every thread adds to its own counters, WFC_TIME(phase) times the rest of the scope it's in,
+// profileDump() writes the sums as JSON at the end of a run, and with WFC_TRACE set in the
+// environment it also writes every timed scope as a Chrome trace (chrome://tracing, Perfetto)
+// without WFC_STATS the macro and profileDump() compile to nothing
+
+enum Phase{
+    // taking the cell with the fewest possibilities
+    PHASE_SELECT,
+    // fixing a cell to one tile, without the propagation after it
+    PHASE_COLLAPSE,
+    PHASE_PROPAGATE,
+    // clearing BBM blocks and backjumping, the propagation they do is counted in it too
+    PHASE_REPAIR,
+    PHASE_RENDER,
+    PHASE_COUNT
+};
+inline const char* phaseName(int phase){
+    static const char* names[PHASE_COUNT] = {"select","collapse","propagate","repair","render"};
+    return names[phase];
+}
+
+#ifdef WFC_STATS
+
+struct TraceEvent{
+    int phase;
+    // nanoseconds on the steady clock
+    long long start;
+    long long duration;
+};
+
+struct ThreadProfile{
+    int id;
+    long long calls[PHASE_COUNT] = {};
+    long long nanos[PHASE_COUNT] = {};
+    std::vector<TraceEvent> events;
+};
+
+// profiles of every thread that timed anything, they outlive their threads
+// a thread's profile is a few counters, the events are what takes room, so their cap is for all
+// threads together, however many thread pools come and go
+struct ProfileRegistry{
+    // a trace keeps at most this many events in the whole process
+    static constexpr long long MAX_EVENTS = 1 << 20;
+
+    std::mutex mtx;
+    std::vector<std::unique_ptr<ThreadProfile>> threads;
+    bool trace = std::getenv("WFC_TRACE") != nullptr;
+    // every event timed with the trace on, the ones past MAX_EVENTS are dropped
+    std::atomic<long long> traced{0};
+
+    ThreadProfile* add(){
+        std::lock_guard<std::mutex> lock(mtx);
+        threads.emplace_back(new ThreadProfile());
+        threads.back()->id = threads.size()-1;
+        return threads.back().get();
+    }
+};
+inline ProfileRegistry& profileRegistry(){
+    static ProfileRegistry registry;
+    return registry;
+}
+inline ThreadProfile& threadProfile(){
+    thread_local ThreadProfile* profile = profileRegistry().add();
+    return *profile;
+}
+
+struct ScopedTimer{
+    int phase;
+    std::chrono::steady_clock::time_point start;
+
+    ScopedTimer(int _phase) : phase(_phase), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer(){
+        auto end = std::chrono::steady_clock::now();
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count();
+        ThreadProfile& profile = threadProfile();
+        profile.calls[phase]++;
+        profile.nanos[phase] += ns;
+        ProfileRegistry& registry = profileRegistry();
+        if(!registry.trace) return;
+        if(registry.traced.fetch_add(1,std::memory_order_relaxed) >= ProfileRegistry::MAX_EVENTS) return;
+        long long since = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+        profile.events.push_back({phase,since,ns});
+    }
+};
+
+#define WFC_TIME_CAT2(a,b) a##b
+#define WFC_TIME_CAT(a,b) WFC_TIME_CAT2(a,b)
+#define WFC_TIME(phase) ScopedTimer WFC_TIME_CAT(wfcTimer,__LINE__)(phase)
+
+// sums of all threads and the counters of stats if given
+inline void profileJson(std::ostream& out, const RunStats* stats = nullptr){
+    ProfileRegistry& registry = profileRegistry();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    long long calls[PHASE_COUNT] = {};
+    long long nanos[PHASE_COUNT] = {};
+    for(auto& t : registry.threads){
+        for(int p = 0; p < PHASE_COUNT; p++){
+            calls[p] += t->calls[p];
+            nanos[p] += t->nanos[p];
+        }
+    }
+
+    out << "{\n  \"phases\": {";
+    for(int p = 0; p < PHASE_COUNT; p++){
+        out << (p ? ",\n" : "\n") << "    \"" << phaseName(p) << "\": {\"calls\": " << calls[p] << ", \"ms\": " << nanos[p]/1e6 << "}";
+    }
+    out << "\n  },\n  \"threads\": [";
+    for(size_t i = 0; i < registry.threads.size(); i++){
+        ThreadProfile& t = *registry.threads[i];
+        out << (i ? ",\n" : "\n") << "    {\"id\": " << t.id;
+        for(int p = 0; p < PHASE_COUNT; p++) out << ", \"" << phaseName(p) << "_ms\": " << t.nanos[p]/1e6;
+        out << "}";
+    }
+    out << "\n  ]";
+    if(stats){
+        out << ",\n  \"counters\": {\"contradictions\": " << stats->contradictions
+            << ", \"wipes\": " << stats->wipes << ", \"wipedCells\": " << stats->wipedCells
+            << ", \"restarts\": " << stats->restarts << ", \"backtracks\": " << stats->backtracks << "}";
+    }
+    out << "\n}\n";
+}
+// every recorded scope in the Chrome trace event format
+inline void profileTrace(std::ostream& out){
+    ProfileRegistry& registry = profileRegistry();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    // timestamps are in microseconds
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\": [";
+    bool first = true;
+    for(auto& t : registry.threads){
+        for(TraceEvent& e : t->events){
+            out << (first ? "\n" : ",\n") << "{\"name\": \"" << phaseName(e.phase) << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << t->id
+                << ", \"ts\": " << e.start/1e3 << ", \"dur\": " << e.duration/1e3 << "}";
+            first = false;
+        }
+    }
+    long long dropped = std::max(registry.traced.load()-ProfileRegistry::MAX_EVENTS,0LL);
+    out << "\n], \"droppedEvents\": " << dropped << "}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+// writes wfc_stats.json, and wfc_trace.json if WFC_TRACE is set
+inline void profileDump(const RunStats* stats = nullptr){
+    std::ofstream json("wfc_stats.json");
+    profileJson(json,stats);
+    if(profileRegistry().trace){
+        std::ofstream trace("wfc_trace.json");
+        profileTrace(trace);
+    }
+}
+
+#else
+
+#define WFC_TIME(phase) ((void)0)
+
+inline void profileDump(const RunStats* = nullptr){}
+
+#endif
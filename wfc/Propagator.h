@@ -0,0 +1,374 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include "Rules.h"
+#include "IndexedHeap.h"
+#include "Grid.h"
+#include "Random.h"
+#include "Profile.h"
+
+// a removed tile and the decisions it depends on
+// level is the deepest decision it depends on, not counting the current one,
+// current is set if it depends on the current decision too
+struct Ban{
+    int cell;
+    int tile;
+    int level;
+    bool current;
+};
+// a ban on the trail with what the cell's dependencies were before it
+struct TrailEntry{
+    int cell;
+    int tile;
+    int prevLevel;
+    bool prevCurrent;
+};
+
+// AC-4 style constraint propagation over a N x M grid of domains
+//
+// supports[(cell*tileCount+tile)*4+d] holds how many tiles of the neighbour in direction d
+// still allow tile at cell. Banning a tile decrements the supports it gave to its neighbours,
+// a tile that runs out of support in any direction gets banned too, until nothing changes.
+//
+// the grid is padded with a border of cells that never run out of support, so neighbours can be
+// reached with a fixed offset and no bounds checks. A padding cell is empty and allows everything,
+// unless the grid is a window of a bigger one, then it holds the tile next to the window
+// cells are indices of a Grid with padding 1, the same as the output grid of the engines
+struct Propagator{
+    static constexpr int BIG_SUPPORT = 1 << 30;
+
+    Rules* rules = nullptr;
+    int n = 0;
+    int m = 0;
+    int stride = 0;
+    int delta[4];
+
+    Grid<Domain> domains;
+    std::vector<int> supports;
+    // fullSupport[tile*4+d] - the support of tile from a neighbour in direction d that still has every tile,
+    // what most cells start with, counted once instead of for every cell
+    std::vector<int> fullSupport;
+    // tiles that lost all support but aren't banned yet
+    std::vector<Ban> pending;
+
+    // every ban in order, only kept when useTrail is set, see mark() and undo()
+    bool useTrail = false;
+    std::vector<TrailEntry> trail;
+    // decisions the bans of each cell depend on, only kept when useTrail is set
+    // a tile banned because it lost support in a cell depends on everything that cell depends on
+    std::vector<int> depLevel;
+    std::vector<char> depCurrent;
+
+    // cells whose domain shrank since clearChanged()
+    std::vector<int> changed;
+    std::vector<char> isChanged;
+
+    // cell that ran out of tiles, -1 if there is none
+    int conflict = -1;
+
+    // total weight and sum of w*log(w) of every domain, only kept for weighted rules,
+    // a ban or an undo changes them by one tile so the entropy of a cell never needs a scan
+    std::vector<double> weightSum;
+    std::vector<double> weightLogSum;
+
+    int index(int x, int y) const {
+        return domains.index(x,y);
+    }
+    int getX(int cell) const {
+        return domains.getX(cell);
+    }
+    int getY(int cell) const {
+        return domains.getY(cell);
+    }
+    bool isInside(int cell) const {
+        return domains.isInside(cell);
+    }
+    Domain& domain(int x, int y){
+        return domains(x,y);
+    }
+    int& support(int cell, int tile, int d){
+        return supports[((size_t)cell*rules->tileCount+tile)*4+d];
+    }
+
+    // fills every cell with every tile, returns false if the tileset can't fill the grid at all
+    bool init(Rules& r, int _n, int _m){
+        rules = &r;
+        n = _n;
+        m = _m;
+        domains.assign(n,m,rules->all,1,Domain());
+        return setup();
+    }
+    // starts from a grid with padding 1, a cell with a tile gets only that tile, -1 gets every tile,
+    // anything else is left empty like the padding, so it restricts nothing
+    // tiles in the padding restrict the cells next to them, so the grid can be a window of a bigger one
+    bool init(Rules& r, const Grid<int>& start){
+        rules = &r;
+        n = start.n;
+        m = start.m;
+        domains.assign(n,m,rules->all,1,Domain());
+        for(int cell = 0; cell < domains.cells(); cell++){
+            if(start[cell] >= 0){
+                domains[cell] = Domain();
+                domains[cell].set(start[cell]);
+            }else if(start[cell] != -1 && isInside(cell)){
+                domains[cell] = Domain();
+            }
+        }
+        return setup();
+    }
+    bool setup(){
+        stride = domains.stride;
+        for(int d = 0; d < 4; d++) delta[d] = domains.delta[d];
+
+        int cells = domains.cells();
+        supports.assign((size_t)cells*rules->tileCount*4, BIG_SUPPORT);
+        fullSupport.resize(rules->tileCount*4);
+        for(int t = 0; t < rules->tileCount; t++){
+            for(int d = 0; d < 4; d++) fullSupport[t*4+d] = rules->compatible[d][t].size();
+        }
+        pending.clear();
+        // a wave of bans seldom has more than one per cell waiting
+        pending.reserve(cells);
+        trail.clear();
+        depLevel.assign(cells,-1);
+        depCurrent.assign(cells,0);
+        changed.clear();
+        changed.reserve(cells);
+        isChanged.assign(cells, 0);
+        conflict = -1;
+        weightSum.assign(rules->weighted ? cells : 0, 0);
+        weightLogSum.assign(rules->weighted ? cells : 0, 0);
+        for(int cell = 0; cell < cells && rules->weighted; cell++) refreshWeights(cell);
+
+        for(int x = 0; x < n; x++){
+            for(int y = 0; y < m; y++){
+                computeSupports(index(x,y));
+            }
+        }
+        for(int x = 0; x < n; x++){
+            for(int y = 0; y < m; y++){
+                queueUnsupported(index(x,y));
+            }
+        }
+        // a window can start with an empty cell, the rest still has to reach a fixpoint
+        return propagate(false);
+    }
+
+    // sets the weight sums of a cell from its domain, after the domain was set directly
+    void refreshWeights(int cell){
+        if(rules->weighted) weightSums(*rules,domains[cell],weightSum[cell],weightLogSum[cell]);
+    }
+    // gives a cell only the given tile, without propagating
+    void setTile(int cell, int tile){
+        domains[cell] = Domain();
+        domains[cell].set(tile);
+        refreshWeights(cell);
+    }
+    // order in which cells get collapsed, lowest first, the domain size or with weighted rules
+    // the entropy of the weights, a cell that ran out of tiles comes before everything
+    double priority(int cell) const {
+        if(!rules->weighted) return domains[cell].size();
+        if(domains[cell].empty()) return -1;
+        return entropy(weightSum[cell],weightLogSum[cell]);
+    }
+    // priority as a whole number from 0 to tileCount for bucketed queues, the size or
+    // with weighted rules exp(entropy), the amount of equally likely tiles with the same entropy
+    int bucket(int cell) const {
+        if(!rules->weighted || domains[cell].empty()) return domains[cell].size();
+        int b = (int)std::lround(std::exp(entropy(weightSum[cell],weightLogSum[cell])));
+        return std::min(std::max(b,1),rules->tileCount);
+    }
+    // a random tile of the cell, by weight if the rules have weights
+    int pick(Rng& rng, int cell) const {
+        if(!rules->weighted) return getRandomFromDomain(rng,domains[cell]);
+        return getRandomFromDomain(rng,domains[cell],rules->weights,weightSum[cell]);
+    }
+
+    // removes tile from cell, returns false if the cell ran out of tiles
+    // the last tile of a cell doesn't take support away from the neighbours, so a conflict stays local
+    bool ban(int cell, int tile, int level = -1, bool current = false){
+        Domain& dom = domains[cell];
+        dom.reset(tile);
+        if(rules->weighted){
+            weightSum[cell] -= rules->weights[tile];
+            weightLogSum[cell] -= rules->weightLogs[tile];
+        }
+        if(useTrail){
+            trail.push_back({cell,tile,depLevel[cell],(bool)depCurrent[cell]});
+            depLevel[cell] = std::max(depLevel[cell],level);
+            depCurrent[cell] |= current;
+        }
+        if(!isChanged[cell]){
+            isChanged[cell] = 1;
+            changed.push_back(cell);
+        }
+        if(dom.empty()){
+            conflict = cell;
+            return false;
+        }
+
+        int nextLevel = useTrail ? depLevel[cell] : -1;
+        bool nextCurrent = useTrail && depCurrent[cell];
+        for(int d = 0; d < 4; d++){
+            int nb = cell+delta[d];
+            int back = (d+2)%4;
+            Domain& comp = rules->compatible[d][tile];
+            for(int u = comp.next(-1); u != -1; u = comp.next(u)){
+                if(--support(nb,u,back) == 0 && domains[nb].test(u)) pending.push_back({nb,u,nextLevel,nextCurrent});
+            }
+        }
+        return true;
+    }
+    // bans every other tile of the cell and propagates, the bans depend only on the current decision
+    bool collapse(int cell, int tile, bool stopOnConflict = true){
+        {
+            WFC_TIME(PHASE_COLLAPSE);
+            Domain dom = domains[cell];
+            for(int t = dom.next(-1); t != -1; t = dom.next(t)){
+                if(t != tile) ban(cell,t,-1,true);
+            }
+        }
+        return propagate(stopOnConflict);
+    }
+    // bans everything that lost support, returns false if some cell ran out of tiles
+    // without stopOnConflict the rest of the grid is still brought to a fixpoint
+    bool propagate(bool stopOnConflict = true){
+        WFC_TIME(PHASE_PROPAGATE);
+        bool ok = conflict == -1;
+        while(!pending.empty()){
+            Ban cur = pending.back();
+            pending.pop_back();
+            if(!domains[cur.cell].test(cur.tile)) continue;
+            if(!ban(cur.cell,cur.tile,cur.level,cur.current)){
+                ok = false;
+                if(stopOnConflict){
+                    pending.clear();
+                    return false;
+                }
+            }
+        }
+        return ok;
+    }
+
+    size_t mark() const {
+        return trail.size();
+    }
+    // puts back every ban made after mark
+    void undo(size_t mark){
+        while(trail.size() > mark){
+            TrailEntry cur = trail.back();
+            trail.pop_back();
+            int cell = cur.cell;
+            int tile = cur.tile;
+            depLevel[cell] = cur.prevLevel;
+            depCurrent[cell] = cur.prevCurrent;
+            // the last tile of a cell never took any support away
+            bool wasEmpty = domains[cell].empty();
+            domains[cell].set(tile);
+            if(rules->weighted){
+                weightSum[cell] += rules->weights[tile];
+                weightLogSum[cell] += rules->weightLogs[tile];
+            }
+            if(wasEmpty) continue;
+
+            for(int d = 0; d < 4; d++){
+                int nb = cell+delta[d];
+                int back = (d+2)%4;
+                Domain& comp = rules->compatible[d][tile];
+                for(int u = comp.next(-1); u != -1; u = comp.next(u)) support(nb,u,back)++;
+            }
+        }
+        pending.clear();
+        conflict = -1;
+    }
+    // the current decision becomes an ordinary one at the given level,
+    // call before clearChanged() once the bans of a decision are done
+    void finishLevel(int level){
+        for(int cell : changed){
+            if(!depCurrent[cell]) continue;
+            depLevel[cell] = level;
+            depCurrent[cell] = 0;
+        }
+    }
+
+    void clearChanged(){
+        for(int cell : changed) isChanged[cell] = 0;
+        changed.clear();
+    }
+
+    // gives every empty cell of the block all tiles again and rebuilds the supports around it,
+    // collapsed cells (res != -1) keep their tile
+    bool resetBlock(int minX, int maxX, int minY, int maxY, Grid<int>& res){
+        WFC_TIME(PHASE_REPAIR);
+        conflict = -1;
+        for(int x = std::max(minX-1,0); x <= std::min(maxX+1,n-1); x++){
+            for(int y = std::max(minY-1,0); y <= std::min(maxY+1,m-1); y++){
+                int cell = index(x,y);
+                if(res[cell] != -1) continue;
+                domains[cell] = rules->all;
+                if(rules->weighted) refreshWeights(cell);
+                if(!isChanged[cell]){
+                    isChanged[cell] = 1;
+                    changed.push_back(cell);
+                }
+            }
+        }
+        for(int x = std::max(minX-2,0); x <= std::min(maxX+2,n-1); x++){
+            for(int y = std::max(minY-2,0); y <= std::min(maxY+2,m-1); y++){
+                computeSupports(index(x,y));
+            }
+        }
+        for(int x = std::max(minX-2,0); x <= std::min(maxX+2,n-1); x++){
+            for(int y = std::max(minY-2,0); y <= std::min(maxY+2,m-1); y++){
+                queueUnsupported(index(x,y));
+            }
+        }
+        return propagate(false);
+    }
+
+    // counts supports of a cell from the current neighbour domains
+    // empty padding and cells that already ran out of tiles allow everything
+    void computeSupports(int cell){
+        for(int d = 0; d < 4; d++){
+            int nb = cell+delta[d];
+            bool wildcard = domains[nb].empty();
+            bool full = domains[nb] == rules->all;
+            for(int t = 0; t < rules->tileCount; t++){
+                if(wildcard){
+                    support(cell,t,d) = BIG_SUPPORT;
+                    continue;
+                }
+                if(full){
+                    support(cell,t,d) = fullSupport[t*4+d];
+                    continue;
+                }
+                Domain both = rules->compatible[d][t];
+                both &= domains[nb];
+                support(cell,t,d) = both.size();
+            }
+        }
+    }
+    void queueUnsupported(int cell){
+        Domain& dom = domains[cell];
+        for(int t = dom.next(-1); t != -1; t = dom.next(t)){
+            for(int d = 0; d < 4; d++){
+                if(support(cell,t,d) == 0){
+                    pending.push_back({cell,t,-1,false});
+                    break;
+                }
+            }
+        }
+    }
+};
+
+// pushes the cells touched by the last propagation that aren't collapsed yet with their new priority
+// cells of the heap and res are indexed like the propagator
+inline void pushChanged(IndexedHeap<double>& pq, Propagator& prop, Grid<int>& res){
+    for(int cell : prop.changed){
+        if(res[cell] == -1) pq.push(cell,prop.priority(cell));
+    }
+    prop.clearChanged();
+}
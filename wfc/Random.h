@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Domain.h"
+
+// SplitMix64, the state only counts up, so a stream is fully set by its seed
+// and a stream for any key can be made on the spot with hashKey
+struct SplitMix{
+    typedef uint64_t result_type;
+    uint64_t state;
+
+    explicit SplitMix(uint64_t seed = 0) : state(seed) {}
+
+    static uint64_t mix(uint64_t z){
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    uint64_t operator()(){
+        state += 0x9e3779b97f4a7c15ULL;
+        return mix(state);
+    }
+    static constexpr uint64_t min(){
+        return 0;
+    }
+    static constexpr uint64_t max(){
+        return UINT64_MAX;
+    }
+};
+typedef SplitMix Rng;
+
+// seed of the stream for key (a,b) under seed, e.g. a chunk's coordinates
+inline uint64_t hashKey(uint64_t seed, int64_t a, int64_t b = 0){
+    uint64_t h = SplitMix::mix(seed + 0x9e3779b97f4a7c15ULL);
+    h = SplitMix::mix(h ^ (uint64_t)a);
+    return SplitMix::mix(h ^ ((uint64_t)b * 0x9e3779b97f4a7c15ULL));
+}
+
+// not std::uniform_int_distribution, its results differ between standard libraries
+// the modulo bias is below 2^-50 for any range used here
+// an empty range (to < from) gives from without drawing
+inline int getRandom(Rng& rng, int from, int to){
+    if(to < from) return from;
+    return from + (int)(rng() % (uint64_t)(to-from+1));
+}
+// -1 for an empty domain
+inline int getRandomFromDomain(Rng& rng, const Domain& d){
+    return d.nth(getRandom(rng,0,d.size()-1));
+}
+// a tile of the domain picked with probability weights[t]/total, total is the sum of its weights
+inline int getRandomFromDomain(Rng& rng, const Domain& d, const std::vector<double>& weights, double total){
+    double r = (rng() >> 11) * 0x1.0p-53 * total;
+    int last = -1;
+    for(int t = d.next(-1); t != -1; t = d.next(t)){
+        r -= weights[t];
+        if(r < 0) return t;
+        last = t;
+    }
+    // the sum can be off by rounding
+    return last;
+}
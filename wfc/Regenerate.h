@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "Propagator.h"
+#include "Grid.h"
+#include "WFCchunked.h"
+
+// Regenerating part of a finished grid - after pinning or changing a few tiles, only the edited
+// area is made again, the way BBM clears a block and refills it
+
+// gives every cell of res in [minX,maxX] x [minY,maxY] a new tile, except the pinned ones,
+// which get the tile of their pin. A pin outside the rectangle can't change its cell,
+// it only keeps it from being cleared
+// the new cells fit the cells around the rectangle, a conflict at its edge may clear and refill
+// cells up to config.blockRadius+1 outside it, the rest of res isn't touched
+// the work only depends on the size of the rectangle and the block radius, not on the grid
+inline void regenerate(Rules& rules, Config& config, Rng& rng, Grid<int>& res, const std::vector<Pin>& pins, int minX, int maxX, int minY, int maxY){
+    int R = config.blockRadius;
+    minX = std::max(minX,0);
+    maxX = std::min(maxX,res.n-1);
+    minY = std::max(minY,0);
+    maxY = std::min(maxY,res.m-1);
+    for(const Pin& p : pins){
+        if(p.x < 0 || p.y < 0 || p.x >= res.n || p.y >= res.m) throw std::invalid_argument("pin outside the grid");
+        if(p.tile < 0 || p.tile >= rules.tileCount) throw std::invalid_argument("pin with an unknown tile");
+    }
+    if(minX > maxX || minY > maxY) return;
+    for(const Pin& p : pins){
+        bool inside = p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY;
+        if(!inside && res(p.x,p.y) != p.tile) throw std::invalid_argument("pin outside the rectangle changes its cell");
+    }
+
+    // pins that can't be next to each other would make BBM clear around them forever,
+    // the pins of the window alone have to leave every cell of it a tile
+    int x0 = std::max(minX-R-1,0);
+    int x1 = std::min(maxX+R+1,res.n-1);
+    int y0 = std::max(minY-R-1,0);
+    int y1 = std::min(maxY+R+1,res.m-1);
+    Grid<int> start(x1-x0+1,y1-y0+1,-1,1,OUTSIDE);
+    for(const Pin& p : pins){
+        if(p.x < x0 || p.x > x1 || p.y < y0 || p.y > y1) continue;
+        int& cell = start(p.x-x0,p.y-y0);
+        if(cell != -1 && cell != p.tile) throw std::invalid_argument("two pins on one cell");
+        cell = p.tile;
+    }
+    Propagator check;
+    if(!check.init(rules,start)) throw std::invalid_argument("pinned tiles don't fit together");
+
+    for(int x = minX; x <= maxX; x++){
+        for(int y = minY; y <= maxY; y++) res(x,y) = -1;
+    }
+    for(const Pin& p : pins) res(p.x,p.y) = p.tile;
+    solveRegion(rules,res,minX,maxX,minY,maxY,R,config.minBlockRadius,rng,config.stats,pins);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+
+// how far BBM clears around a conflict
+// the grid is split into REGION x REGION regions that each remember how often conflicts came back
+// to them, a conflict clears minRadius around it in a calm region and twice as far each time it
+// comes back, up to maxRadius.
+// A region calms down one step once twice as many cells as its next clear would wipe, and at least
+// REGION*REGION, were filled in it with no conflict in it
+struct RepairRadius{
+    static constexpr int REGION = 8;
+
+    int minRadius;
+    int maxRadius;
+    int cols;
+    // how many times the radius has doubled in a region
+    std::vector<int> heat;
+    // cells filled in a region since it last got hotter or calmer
+    std::vector<int> calm;
+
+    void init(int n, int m, int _minRadius, int _maxRadius){
+        maxRadius = std::max(_maxRadius,1);
+        minRadius = std::min(std::max(_minRadius,1),maxRadius);
+        cols = (m+REGION-1)/REGION;
+        int regions = (n+REGION-1)/REGION*cols;
+        heat.assign(regions,0);
+        calm.assign(regions,0);
+    }
+
+    int region(int x, int y) const {
+        return x/REGION*cols+y/REGION;
+    }
+    int radius(int r) const {
+        return std::min(minRadius << heat[r],maxRadius);
+    }
+
+    // the radius to clear around a conflict at (x,y), the region gets hotter
+    int failure(int x, int y){
+        int r = region(x,y);
+        int res = radius(r);
+        if(res < maxRadius) heat[r]++;
+        calm[r] = 0;
+        return res;
+    }
+    // (x,y) was filled without a conflict
+    void success(int x, int y){
+        int r = region(x,y);
+        if(heat[r] == 0) return;
+        int side = 2*radius(r)+1;
+        if(++calm[r] >= std::max(REGION*REGION,2*side*side)){
+            heat[r]--;
+            calm[r] = 0;
+        }
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include <cmath>
+#include <stdexcept>
+#include "Domain.h"
+#include "Tile.h"
+#include "Sockets.h"
+
+// directions follow the offsets array: 0 - up, 1 - right, 2 - down, 3 - left
+// neighbour in direction i of (x,y) is (x+offsets[i], y+offsets[i+1])
+constexpr int offsets[5] = {-1,0,1,0,-1};
+
+// adjacency rules compiled once from a tileset
+struct Rules{
+    int tileCount = 0;
+    int tileSize = 0;
+    int socketCount = 0;
+    // sockets[d][t] - interned id of side d of tile t
+    std::vector<int> sockets[4];
+    // compatible[d][t] - tiles that can be placed in direction d of tile t
+    std::vector<Domain> compatible[4];
+    // every tile of the tileset
+    Domain all;
+    // how often each tile should show up, all 1 until setWeights() makes them differ,
+    // cells are then picked by the entropy of their weights instead of their size
+    bool weighted = false;
+    std::vector<double> weights;
+    // w*log(w) of every weight
+    std::vector<double> weightLogs;
+};
+
+// gives tile t the weight weights[t], weights must be positive
+inline void setWeights(Rules& rules, const std::vector<double>& weights){
+    if((int)weights.size() != rules.tileCount) throw std::invalid_argument("a tileset needs one weight per tile");
+    rules.weighted = false;
+    for(int t = 0; t < rules.tileCount; t++){
+        if(!(weights[t] > 0)) throw std::invalid_argument("tile weights must be positive");
+        if(weights[t] != weights[0]) rules.weighted = true;
+        rules.weights[t] = weights[t];
+        rules.weightLogs[t] = weights[t]*std::log(weights[t]);
+    }
+}
+// total weight and sum of w*log(w) of the tiles of a domain
+inline void weightSums(const Rules& rules, const Domain& d, double& sum, double& sumLog){
+    sum = 0;
+    sumLog = 0;
+    for(int t = d.next(-1); t != -1; t = d.next(t)){
+        sum += rules.weights[t];
+        sumLog += rules.weightLogs[t];
+    }
+}
+// Shannon entropy of picking a tile with probability w/sum, log(sum) - sum(w*log(w))/sum
+inline double entropy(double sum, double sumLog){
+    return sum > 0 ? std::log(sum) - sumLog/sum : 0;
+}
+
+inline Rules compileRules(std::vector<Tile>& tiles, char emptyChar){
+    if(tiles.empty()) throw std::invalid_argument("tileset is empty");
+    if(tiles.size() > WFC_MAX_TILES) throw std::length_error("tileset has more than WFC_MAX_TILES tiles");
+
+    Rules rules;
+    rules.tileCount = tiles.size();
+    rules.tileSize = tiles[0].size;
+    for(Tile& t : tiles){
+        if(t.size != rules.tileSize) throw std::invalid_argument("tiles of a tileset must have the same size");
+    }
+
+    // intern sides
+    std::map<std::string,int> ids;
+    std::vector<std::string> sides;
+    int T = rules.tileCount;
+    for(int d = 0; d < 4; d++){
+        rules.sockets[d].resize(T);
+        for(int t = 0; t < T; t++){
+            std::string side = tiles[t].getSide(d);
+            auto it = ids.find(side);
+            if(it == ids.end()){
+                it = ids.insert({side,(int)sides.size()}).first;
+                sides.push_back(side);
+            }
+            rules.sockets[d][t] = it->second;
+        }
+    }
+    rules.socketCount = sides.size();
+
+    // every socket is checked against all the others at once, fit has a row of bits per socket
+    SocketTable table;
+    table.init(sides,rules.tileSize,emptyChar);
+    int words = table.words();
+    std::vector<uint64_t> fit((size_t)rules.socketCount*words);
+    for(int a = 0; a < rules.socketCount; a++) table.fitMask(sides[a].data(),&fit[(size_t)a*words]);
+
+    for(int d = 0; d < 4; d++){
+        rules.compatible[d].assign(T, Domain());
+        for(int t = 0; t < T; t++){
+            const uint64_t* row = &fit[(size_t)rules.sockets[d][t]*words];
+            for(int u = 0; u < T; u++){
+                int b = rules.sockets[(d+2)%4][u];
+                if((row[b>>6] >> (b&63)) & 1) rules.compatible[d][t].set(u);
+            }
+        }
+    }
+    for(int t = 0; t < T; t++) rules.all.set(t);
+    rules.weights.assign(T,1);
+    rules.weightLogs.assign(T,0);
+
+    return rules;
+}
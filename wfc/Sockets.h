@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+// SSE2 is always there on x86-64, AVX2 only when the compiler is told so, e.g. -mavx2 or /arch:AVX2
+// -DWFC_NO_SIMD forces the plain loops
+#if !defined(WFC_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define WFC_SOCKETS_AVX2
+#elif !defined(WFC_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define WFC_SOCKETS_SSE2
+#endif
+
+// the distinct sides of a tileset stored char position by char position, chars[i*stride+s] is
+// char i of side s and wild[i*stride+s] is -1 where that char is emptyChar,
+// so one load reads a position of many sides and a side is checked against all of them at once
+struct SocketTable{
+    // sides are handled 64 at a time, one word of the result each
+    static constexpr int BLOCK = 64;
+
+    int size = 0;
+    int count = 0;
+    int stride = 0;
+    char emptyChar = 0;
+    std::vector<char> chars;
+    std::vector<char> wild;
+
+    void init(const std::vector<std::string>& sides, int _size, char _emptyChar){
+        size = _size;
+        count = sides.size();
+        stride = (count+BLOCK-1)/BLOCK*BLOCK;
+        emptyChar = _emptyChar;
+        // the padding after the last side is cut off the results
+        chars.assign((size_t)size*stride,0);
+        wild.assign((size_t)size*stride,0);
+        for(int s = 0; s < count; s++){
+            if((int)sides[s].size() != size) throw std::invalid_argument("sides of a socket table must have the same length");
+            for(int i = 0; i < size; i++){
+                chars[(size_t)i*stride+s] = sides[s][i];
+                wild[(size_t)i*stride+s] = sides[s][i] == emptyChar ? -1 : 0;
+            }
+        }
+    }
+    // words of a result
+    int words() const {
+        return stride/BLOCK;
+    }
+
+    // bit b of out is set if side b fits against side, out has words() words
+    // facing sides fit when one is the reverse of the other, emptyChar on either side fits anything
+    void fitMask(const char* side, uint64_t* out) const {
+        for(int w = 0; w < words(); w++){
+            uint64_t res = ~uint64_t(0);
+            for(int i = 0; i < size && res; i++){
+                char c = side[i];
+                if(c == emptyChar) continue;
+                size_t at = (size_t)(size-1-i)*stride + (size_t)w*BLOCK;
+                res &= fitBlock(&chars[at],&wild[at],c);
+            }
+            int left = count - w*BLOCK;
+            if(left < BLOCK) res &= (uint64_t(1) << left) - 1;
+            out[w] = res;
+        }
+    }
+
+    // bit k is set if col[k] is c or wild[k] is set, for 64 sides
+    static uint64_t fitBlock(const char* col, const char* wl, char c){
+#if defined(WFC_SOCKETS_AVX2)
+        __m256i needle = _mm256_set1_epi8(c);
+        uint64_t res = 0;
+        for(int k = 0; k < BLOCK; k += 32){
+            __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(col+k)), needle);
+            __m256i ok = _mm256_or_si256(eq, _mm256_loadu_si256((const __m256i*)(wl+k)));
+            res |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ok) << k;
+        }
+        return res;
+#elif defined(WFC_SOCKETS_SSE2)
+        __m128i needle = _mm_set1_epi8(c);
+        uint64_t res = 0;
+        for(int k = 0; k < BLOCK; k += 16){
+            __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(col+k)), needle);
+            __m128i ok = _mm_or_si128(eq, _mm_loadu_si128((const __m128i*)(wl+k)));
+            res |= (uint64_t)(uint32_t)_mm_movemask_epi8(ok) << k;
+        }
+        return res;
+#else
+        uint64_t res = 0;
+        for(int k = 0; k < BLOCK; k++) res |= (uint64_t)(col[k] == c || wl[k]) << k;
+        return res;
+#endif
+    }
+};
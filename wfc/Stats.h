@@ -0,0 +1,29 @@
+#pragma once
+#include <atomic>
+
+// what a run had to do besides placing tiles, set Config::stats to collect it
+// every counter can be bumped from several threads at once
+struct RunStats{
+    // cells that ran out of tiles
+    std::atomic<long long> contradictions{0};
+    // BBM blocks cleared and the cells in them
+    std::atomic<long long> wipes{0};
+    std::atomic<long long> wipedCells{0};
+    // Reset attempts thrown away
+    std::atomic<long long> restarts{0};
+    // decisions undone by backtracking
+    std::atomic<long long> backtracks{0};
+
+    void clear(){
+        contradictions = 0;
+        wipes = 0;
+        wipedCells = 0;
+        restarts = 0;
+        backtracks = 0;
+    }
+};
+
+// bumps a counter of stats if there is one
+inline void count(RunStats* stats, std::atomic<long long> RunStats::*counter, long long amount = 1){
+    if(stats) (stats->*counter).fetch_add(amount,std::memory_order_relaxed);
+}
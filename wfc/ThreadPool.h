@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+// fixed set of worker threads running queued jobs
+// wait() blocks until every queued job is done and rethrows the first exception one of them threw
+struct ThreadPool{
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mtx;
+    std::condition_variable hasJob;
+    std::condition_variable allDone;
+    int running = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    // 0 threads - one per hardware thread
+    ThreadPool(int threads = 0){
+        if(threads <= 0) threads = std::thread::hardware_concurrency();
+        if(threads <= 0) threads = 1;
+        for(int i = 0; i < threads; i++) workers.emplace_back([this]{ work(); });
+    }
+    ~ThreadPool(){
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        hasJob.notify_all();
+        for(std::thread& t : workers) t.join();
+    }
+    int size() const {
+        return workers.size();
+    }
+
+    void push(std::function<void()> job){
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            jobs.push_back(std::move(job));
+        }
+        hasJob.notify_one();
+    }
+    void wait(){
+        std::unique_lock<std::mutex> lock(mtx);
+        allDone.wait(lock, [this]{ return jobs.empty() && running == 0; });
+        if(error){
+            std::exception_ptr e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    void work(){
+        while(true){
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                hasJob.wait(lock, [this]{ return stopping || !jobs.empty(); });
+                if(jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+                running++;
+            }
+            try{
+                job();
+            }catch(...){
+                std::lock_guard<std::mutex> lock(mtx);
+                if(!error) error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                running--;
+                if(jobs.empty() && running == 0) allDone.notify_all();
+            }
+        }
+    }
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include "Kernels.h"
+
+// square tile, the size is taken from the length of the string it's made of
+struct Tile{
+    int size;
+    // size*size chars, row by row
+    std::string disp;
+    // the 4 sides read clockwise, size chars each
+    std::string sockets;
+
+    Tile(std::string s){
+        size = (int)std::lround(std::sqrt((double)s.size()));
+        if(size*size != (int)s.size()) throw std::invalid_argument("tile must be a square: \"" + s + "\"");
+        disp = s;
+        sockets.resize(size*4);
+        getTileKernels(size).readSockets(disp.data(),&sockets[0],size);
+    }
+    char at(int i, int j) const {
+        return disp[i*size+j];
+    }
+    std::string getSide(int i) const {
+        return sockets.substr(i*size,size);
+    }
+    // rotated 90 degrees clockwise
+    Tile getRotated() const {
+        std::string s(size*size,' ');
+        for(int i = 0; i < size; i++){
+            for(int j = 0; j < size; j++){
+                s[i*size+j] = disp[(size-1-j)*size+i];
+            }
+        }
+        return Tile(s);
+    }
+    // mirrored left to right
+    Tile getReflected() const {
+        std::string s(size*size,' ');
+        for(int i = 0; i < size; i++){
+            for(int j = 0; j < size; j++){
+                s[i*size+j] = disp[i*size+size-1-j];
+            }
+        }
+        return Tile(s);
+    }
+};
+
+// the variants of a tile under a symmetry, duplicates included: 1 - only the tile, 2 - and its mirror image,
+// 4 - its 4 rotations, 8 - its rotations and their mirror images, all 8 dihedral variants
+inline std::vector<Tile> getVariants(const Tile& t, int symmetry){
+    if(symmetry != 1 && symmetry != 2 && symmetry != 4 && symmetry != 8) throw std::invalid_argument("symmetry must be 1, 2, 4 or 8");
+    std::vector<Tile> res = {t};
+    if(symmetry == 2) res.push_back(t.getReflected());
+    if(symmetry >= 4){
+        for(int r = 1; r < 4; r++) res.push_back(res.back().getRotated());
+    }
+    if(symmetry == 8){
+        for(int r = 0; r < 4; r++) res.push_back(res[r].getReflected());
+    }
+    return res;
+}
+// adds the tiles of variants that are new among them, weights gets how many of
+// the variants each added tile stands for
+inline void addDistinctTiles(const std::vector<Tile>& variants, std::vector<Tile>& tiles, std::vector<double>& weights){
+    std::unordered_map<std::string,int> seen;
+    for(const Tile& v : variants){
+        auto it = seen.find(v.disp);
+        if(it != seen.end()){
+            weights[it->second]++;
+            continue;
+        }
+        seen[v.disp] = tiles.size();
+        tiles.push_back(v);
+        weights.push_back(1);
+    }
+}
+// adds the first am rotations of t, a rotation that's the same as one before it is added once
+// with how many of the am rotations it stands for as its weight, so a tile with more symmetry than
+// am assumes doesn't show up twice and is still picked as often as all its rotations together
+inline void addRotatedTiles(Tile t, int am, std::vector<Tile>& tiles, std::vector<double>& weights){
+    std::vector<Tile> rotations;
+    for(int i = 0; i < am; i++){
+        rotations.push_back(t);
+        t = t.getRotated();
+    }
+    addDistinctTiles(rotations,tiles,weights);
+}
+// adds the distinct variants of t under the symmetry with how many of the variants each one stands for,
+// with symmetry 8 every tile the rotations and mirrors of t can make, whatever symmetry t has itself
+inline void addSymmetricTiles(const Tile& t, int symmetry, std::vector<Tile>& tiles, std::vector<double>& weights){
+    addDistinctTiles(getVariants(t,symmetry),tiles,weights);
+}
+// merges equal tiles into the first of them, its weight becomes the sum of theirs,
+// returns the old index of every kept tile
+inline std::vector<int> dedupTiles(std::vector<Tile>& tiles, std::vector<double>& weights){
+    std::unordered_map<std::string,int> ids;
+    std::vector<Tile> kept;
+    std::vector<double> keptWeights;
+    std::vector<int> from;
+    for(int t = 0; t < (int)tiles.size(); t++){
+        auto it = ids.find(tiles[t].disp);
+        if(it != ids.end()){
+            keptWeights[it->second] += weights[t];
+            continue;
+        }
+        ids[tiles[t].disp] = kept.size();
+        kept.push_back(tiles[t]);
+        keptWeights.push_back(weights[t]);
+        from.push_back(t);
+    }
+    tiles = std::move(kept);
+    weights = std::move(keptWeights);
+    return from;
+}
+// every size x size window of the image becomes a tile, duplicates included, matched by their sides
+// extractPatterns in Patterns.h makes the distinct windows of the overlapping model instead
+inline std::vector<Tile> getTilesFromImage(std::vector<std::string>& image, int size, std::vector<Tile>& res){
+    for(int i = 0; i+size <= (int)image.size(); i++){
+        for(int j = 0; j+size <= (int)image[0].size(); j++){
+
+            std::string tileImage = "";
+            for(int a = 0; a < size; a++){
+                for(int b = 0; b < size; b++){
+                    tileImage += image[i+a][j+b];
+                }
+            }
+            res.push_back(Tile(tileImage));
+
+        }
+    }
+    return res;
+}
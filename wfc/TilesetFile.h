@@ -0,0 +1,263 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <istream>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "Domain.h"
+#include "Tile.h"
+#include "Rules.h"
+#include "Tilesets.h"
+#include "MappedFile.h"
+
+// Tileset files - tilesets as text instead of Tile literals in main(), and their compiled rules
+// kept in a binary cache next to them
+//
+//  # a comment
+//  name pipe
+//  empty 3
+//  complete
+//  tile 4 2.5
+//  | # |
+//  | ##|
+//  |   |
+//
+// name, empty (the char that fits anything) and complete (any neighbours leave a tile that fits,
+// so plain WFC can't get stuck, left out if it isn't so) come before the tiles, every tile starts with
+// tile [rotations] [weight], rotations 1, 2, 4 or 8 - the 4 rotations and their mirror images
+// (default 1) and weight above 0 (default 1), followed by its rows, each between two '|',
+// as many rows as a row is long
+
+// reads a tileset, the rotations of a tile get its weight and its symmetry group
+// equal tiles are kept once with the sum of their weights, so a tile with more symmetry than its
+// rotations assume isn't added twice, and it's picked exactly as often as all its copies together would be
+inline Tileset parseTileset(std::istream& in){
+    Tileset res{"", {}, 0, false};
+    bool hasEmpty = false;
+    std::vector<std::string> rows;
+    int rotations = 1;
+    double weight = 1;
+    int lineNumber = 0;
+    auto fail = [&](const std::string& what){
+        throw std::invalid_argument("tileset line " + std::to_string(lineNumber) + ": " + what);
+    };
+    // the rows read since the last tile line become its tiles
+    auto finishTile = [&]{
+        if(rows.empty()) return;
+        if(rows.size() != rows[0].size()) fail("a tile needs as many rows as a row is long");
+        std::string disp;
+        for(const std::string& row : rows) disp += row;
+        int group = res.groups.empty() ? 0 : res.groups.back()+1;
+        std::vector<Tile> added;
+        std::vector<double> copies;
+        if(rotations == 8) addSymmetricTiles(Tile(disp),8,added,copies);
+        else addRotatedTiles(Tile(disp),rotations,added,copies);
+        for(int i = 0; i < (int)added.size(); i++){
+            res.tiles.push_back(added[i]);
+            res.weights.push_back(weight*copies[i]);
+            res.groups.push_back(group);
+        }
+        rows.clear();
+    };
+
+    std::string line;
+    bool inTile = false;
+    while(std::getline(in,line)){
+        lineNumber++;
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+        if(!line.empty() && line[0] == '|'){
+            if(!inTile) fail("tile row outside a tile");
+            if(line.size() < 2 || line.back() != '|') fail("a tile row has to end with '|'");
+            std::string row = line.substr(1,line.size()-2);
+            if(!rows.empty() && row.size() != rows[0].size()) fail("rows of a tile must have the same length");
+            rows.push_back(row);
+            continue;
+        }
+        if(inTile && rows.empty()) fail("tile without rows");
+        finishTile();
+        inTile = false;
+        if(line.empty() || line[0] == '#') continue;
+
+        std::istringstream words(line);
+        std::string key;
+        words >> key;
+        if(key == "name"){
+            words >> res.name;
+        }else if(key == "empty"){
+            // the char right after "empty ", so it can be any char but a line break
+            if(line.size() < 7) fail("empty needs a char");
+            res.emptyChar = line[6];
+            hasEmpty = true;
+        }else if(key == "complete"){
+            res.complete = true;
+        }else if(key == "tile"){
+            std::vector<std::string> args;
+            for(std::string w; words >> w;) args.push_back(w);
+            if(args.size() > 2) fail("tile takes rotations and a weight");
+            rotations = 1;
+            weight = 1;
+            try{
+                if(args.size() >= 1) rotations = std::stoi(args[0]);
+                if(args.size() == 2) weight = std::stod(args[1]);
+            }catch(const std::logic_error&){
+                fail("bad number in \"" + line + "\"");
+            }
+            if(rotations != 1 && rotations != 2 && rotations != 4 && rotations != 8) fail("rotations must be 1, 2, 4 or 8");
+            if(!(weight > 0)) fail("a tile weight must be above 0");
+            inTile = true;
+        }else fail("unknown line \"" + line + "\"");
+    }
+    if(inTile && rows.empty()) fail("tile without rows");
+    finishTile();
+    if(!hasEmpty) throw std::invalid_argument("tileset has no empty line");
+    if(res.tiles.empty()) throw std::invalid_argument("tileset has no tiles");
+    std::vector<int> from = dedupTiles(res.tiles,res.weights);
+    std::vector<int> groups;
+    for(int t : from) groups.push_back(res.groups[t]);
+    res.groups = groups;
+    return res;
+}
+
+// 64 bit FNV-1a of the text of a tileset, what its rules cache was made from
+inline uint64_t tilesetHash(const std::string& text){
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(char c : text){
+        h ^= (unsigned char)c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// rules cache, in the byte order of the machine that wrote it:
+//   header, then int32 sockets[4][tileCount], Domain compatible[4][tileCount],
+//   double weights[tileCount], int32 groups[tileCount]
+// a cache made from other text, by another version or with another WFC_MAX_TILES is made again
+struct RulesCacheHeader{
+    char magic[4];
+    uint32_t version;
+    // 0x01020304 as written by this machine
+    uint32_t order;
+    uint32_t domainWords;
+    uint64_t hash;
+    uint32_t tileCount;
+    uint32_t tileSize;
+    uint32_t socketCount;
+    uint32_t unused;
+};
+constexpr char RULES_CACHE_MAGIC[4] = {'W','F','C','R'};
+constexpr uint32_t RULES_CACHE_VERSION = 2;
+
+inline size_t rulesCacheSize(int tileCount){
+    return sizeof(RulesCacheHeader) + (size_t)tileCount*(4*sizeof(int32_t) + 4*sizeof(Domain) + sizeof(double) + sizeof(int32_t));
+}
+
+inline void writeRulesCache(const std::string& path, const Rules& rules, const std::vector<int>& groups, uint64_t hash){
+    MappedFile file;
+    file.create(path,rulesCacheSize(rules.tileCount));
+    RulesCacheHeader h;
+    std::memcpy(h.magic,RULES_CACHE_MAGIC,4);
+    h.version = RULES_CACHE_VERSION;
+    h.order = 0x01020304;
+    h.domainWords = Domain::WORDS;
+    h.hash = hash;
+    h.tileCount = rules.tileCount;
+    h.tileSize = rules.tileSize;
+    h.socketCount = rules.socketCount;
+    h.unused = 0;
+    char* dst = file.data;
+    auto put = [&](const void* src, size_t bytes){
+        std::memcpy(dst,src,bytes);
+        dst += bytes;
+    };
+    put(&h,sizeof(h));
+    for(int d = 0; d < 4; d++){
+        for(int s : rules.sockets[d]){
+            int32_t v = s;
+            put(&v,sizeof(v));
+        }
+    }
+    for(int d = 0; d < 4; d++) put(rules.compatible[d].data(),rules.tileCount*sizeof(Domain));
+    put(rules.weights.data(),rules.tileCount*sizeof(double));
+    for(int g : groups){
+        int32_t v = g;
+        put(&v,sizeof(v));
+    }
+    file.flush();
+}
+// fills rules and groups from the cache at path if it was made from text with this hash,
+// false if there is no such cache
+inline bool readRulesCache(const std::string& path, uint64_t hash, Rules& rules, std::vector<int>& groups){
+    MappedFile file;
+    try{
+        file.open(path);
+    }catch(const std::runtime_error&){
+        return false;
+    }
+    if(file.size < sizeof(RulesCacheHeader)) return false;
+    RulesCacheHeader h;
+    std::memcpy(&h,file.data,sizeof(h));
+    if(std::memcmp(h.magic,RULES_CACHE_MAGIC,4) != 0 || h.version != RULES_CACHE_VERSION || h.order != 0x01020304) return false;
+    if(h.domainWords != Domain::WORDS || h.hash != hash || h.tileCount == 0 || h.tileCount > WFC_MAX_TILES) return false;
+    int T = h.tileCount;
+    if(file.size != rulesCacheSize(T)) return false;
+
+    const char* src = file.data+sizeof(h);
+    auto get = [&](void* dst, size_t bytes){
+        std::memcpy(dst,src,bytes);
+        src += bytes;
+    };
+    Rules res;
+    res.tileCount = T;
+    res.tileSize = h.tileSize;
+    res.socketCount = h.socketCount;
+    std::vector<int32_t> ids(T);
+    for(int d = 0; d < 4; d++){
+        get(ids.data(),T*sizeof(int32_t));
+        res.sockets[d].assign(ids.begin(),ids.end());
+    }
+    for(int d = 0; d < 4; d++){
+        res.compatible[d].resize(T);
+        get(res.compatible[d].data(),T*sizeof(Domain));
+    }
+    for(int t = 0; t < T; t++) res.all.set(t);
+    std::vector<double> weights(T);
+    get(weights.data(),T*sizeof(double));
+    res.weights.assign(T,1);
+    res.weightLogs.assign(T,0);
+    for(double w : weights) if(!(w > 0)) return false;
+    setWeights(res,weights);
+    get(ids.data(),T*sizeof(int32_t));
+    groups.assign(ids.begin(),ids.end());
+    rules = std::move(res);
+    return true;
+}
+
+// reads the tileset file at path into set and gives its rules, from path+".rules" if that was made
+// from the same text, otherwise they're compiled and the cache is written again
+// a cache that can't be written, e.g. in a read-only directory, only costs the compile next time
+inline Rules loadTileset(const std::string& path, Tileset& set){
+    std::ifstream file(path, std::ios::binary);
+    if(!file) throw std::runtime_error("can't open " + path);
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string s = text.str();
+    std::istringstream in(s);
+    set = parseTileset(in);
+    if(set.tiles.size() > WFC_MAX_TILES) throw std::length_error("tileset has more than WFC_MAX_TILES tiles");
+
+    uint64_t hash = tilesetHash(s);
+    std::string cache = path + ".rules";
+    Rules rules;
+    std::vector<int> groups;
+    if(readRulesCache(cache,hash,rules,groups) && rules.tileCount == (int)set.tiles.size() && groups == set.groups) return rules;
+
+    rules = compileRules(set.tiles,set.emptyChar);
+    setWeights(rules,set.weights);
+    try{
+        writeRulesCache(cache,rules,set.groups,hash);
+    }catch(const std::runtime_error&){}
+    return rules;
+}
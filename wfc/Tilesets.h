@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Tile.h"
+
+// a tileset as read from a file (TilesetFile.h)
+struct Tileset{
+    std::string name;
+    std::vector<Tile> tiles;
+    char emptyChar;
+    // any combination of neighbours leaves a tile that fits, so plain WFC never gets stuck
+    bool complete;
+    // the weight of every tile and its symmetry group, the tiles rotated from the same one share a group
+    std::vector<double> weights = {};
+    std::vector<int> groups = {};
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "IndexedHeap.h"
+#include "Grid.h"
+#include "Profile.h"
+#include "Context.h"
+
+// Normal wave function collapse, only the direct neighbours restrict a cell,
+// so the tileset must fill a cell no matter what its neighbours are
+
+inline Domain getPossibilitiesAtCell(int cell, Rules& rules, Grid<int>& res){
+    Domain possib = rules.all;
+    for(int i = 0; i < 4; i++){
+        int next = res[cell+res.delta[i]];
+
+        // empty neighbours and the padding don't restrict the cell
+        if(next >= 0){
+            possib &= rules.compatible[(i+2)%4][next];
+        }
+    }
+    return possib;
+}
+// order in which cells get filled, lowest first, like the propagator's priority: the amount of
+// possibilities or with weighted rules the entropy of their weights, a cell no tile fits comes first
+inline double cellPriority(Rules& rules, const Domain& possib){
+    if(!rules.weighted) return possib.size();
+    if(possib.empty()) return -1;
+    double sum, sumLog;
+    weightSums(rules,possib,sum,sumLog);
+    return entropy(sum,sumLog);
+}
+// fills ctx.res
+inline void solveWFC(Rules& rules, Config& config, Rng& rng, SolverContext& ctx){
+    int N = config.n;
+    int M = config.m;
+    Grid<int>& res = ctx.res;
+    Grid<Domain>& possibilities = ctx.possibilities;
+    res.assign(N,M,-1,1,OUTSIDE);
+    possibilities.assign(N,M,rules.all,1);
+
+    // cells are keyed by their index in res
+    IndexedHeap<double>& pq = ctx.pq;
+    pq.init(res.cells());
+    pq.push(res.index(getRandom(rng,0,N-1), getRandom(rng,0,M-1)), cellPriority(rules,rules.all));
+
+    while(!pq.empty()){
+        int cell;
+        {
+            WFC_TIME(PHASE_SELECT);
+            cell = pq.pop();
+        }
+        // ! NEEDS BACKTRACKING
+
+        {
+            WFC_TIME(PHASE_COLLAPSE);
+            Domain& possib = possibilities[cell];
+            // no tile fits between the neighbours, nothing here can undo them
+            if(possib.empty()) throw std::runtime_error("tileset can't fill the grid");
+            int tileType;
+            if(rules.weighted){
+                double sum, sumLog;
+                weightSums(rules,possib,sum,sumLog);
+                tileType = getRandomFromDomain(rng,possib,rules.weights,sum);
+            }else tileType = getRandomFromDomain(rng,possib);
+            res[cell] = tileType;
+        }
+
+        WFC_TIME(PHASE_PROPAGATE);
+        for(int i = 0; i < 4; i++){
+            int next = cell+res.delta[i];
+
+            if(res[next] == -1){
+                possibilities[next] = getPossibilitiesAtCell(next,rules,res);
+                pq.push(next, cellPriority(rules,possibilities[next]));
+            }
+        }
+    }
+}
+
+inline Grid<int> WFC(Rules& rules, Config& config, Rng& rng){
+    SolverContext ctx;
+    solveWFC(rules,config,rng,ctx);
+    return std::move(ctx.res);
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "Propagator.h"
+#include "IndexedHeap.h"
+#include "Repair.h"
+#include "Grid.h"
+#include "ThreadPool.h"
+#include "Context.h"
+#include "WFCwithBBM.h"
+
+// Chunked generation - BBM on one chunk at a time, chunks that don't touch run in parallel
+
+// a cell that has to keep its tile
+struct Pin{
+    int x;
+    int y;
+    int tile;
+};
+
+// fills every empty cell of res in [minX,maxX] x [minY,maxY] with BBM, clearing minBlockRadius to
+// blockRadius around a conflict like WFCwithBBM does
+// a conflict may wipe and refill filled cells up to blockRadius+1 around the region, and the ring of
+// cells right outside that window is read, nothing else of res is touched
+// empty cells of the window outside the region are left empty and don't restrict anything
+// pinned cells are never wiped, res must already hold their tiles
+// the work buffers come from ctx, so regions solved one after another with one context don't allocate
+inline void solveRegion(Rules& rules, Grid<int>& res, int minX, int maxX, int minY, int maxY, int blockRadius, int minBlockRadius, Rng& rng, RunStats* stats = nullptr, const std::vector<Pin>& pins = {}, SolverContext* ctx = nullptr){
+    SolverContext own;
+    SolverContext& c = ctx ? *ctx : own;
+    int R = blockRadius;
+    int x0 = std::max(minX-R-1,0);
+    int x1 = std::min(maxX+R+1,res.n-1);
+    int y0 = std::max(minY-R-1,0);
+    int y1 = std::min(maxY+R+1,res.m-1);
+    int n = x1-x0+1;
+    int m = y1-y0+1;
+
+    // the window with the ring around it, the region and cells filled before have to be filled
+    // when done, the other empty cells are OUTSIDE, so they don't restrict anything
+    Grid<int>& local = c.res;
+    local.assign(n,m,-1,1,OUTSIDE);
+    for(int x = -1; x <= n; x++){
+        for(int y = -1; y <= m; y++){
+            int cell = local.index(x,y);
+            int tile = res(x0+x,y0+y);
+            bool inRegion = x0+x >= minX && x0+x <= maxX && y0+y >= minY && y0+y <= maxY;
+            if(tile >= 0) local[cell] = tile;
+            else if(local.isInside(cell) && !inRegion) local[cell] = OUTSIDE;
+        }
+    }
+    std::vector<char>& pinned = c.pinned;
+    pinned.assign(local.cells(),0);
+    for(const Pin& p : pins){
+        if(p.x >= x0 && p.x <= x1 && p.y >= y0 && p.y <= y1) pinned[local.index(p.x-x0,p.y-y0)] = 1;
+    }
+    RepairRadius& repair = c.repair;
+    repair.init(n,m,minBlockRadius,R);
+    Propagator& prop = c.prop;
+    prop.useTrail = false;
+    prop.init(rules,local);
+    prop.clearChanged();
+
+    // cells are keyed by their propagator index and ordered by their priority
+    IndexedHeap<double>& pq = c.pq;
+    pq.init(prop.domains.cells());
+    // a cell to fill, or any cell that has to be filled but ran out of tiles
+    auto push = [&](int cell){
+        if(!local.isInside(cell) || local[cell] == OUTSIDE) return;
+        if(local[cell] == -1 || prop.domains[cell].empty()) pq.push(cell,prop.priority(cell));
+    };
+    for(int x = 0; x < n; x++){
+        for(int y = 0; y < m; y++){
+            int cell = local.index(x,y);
+            if(!(prop.domains[cell] == rules.all)) push(cell);
+        }
+    }
+
+    // cells not reachable from anything filled start from a random empty one
+    std::vector<int>& unfilled = c.unfilled;
+    while(true){
+        if(pq.empty()){
+            unfilled.clear();
+            for(int x = 0; x < n; x++){
+                for(int y = 0; y < m; y++){
+                    if(local(x,y) == -1) unfilled.push_back(local.index(x,y));
+                }
+            }
+            if(unfilled.empty()) break;
+            push(unfilled[getRandom(rng,0,unfilled.size()-1)]);
+        }
+
+        int cell;
+        {
+            WFC_TIME(PHASE_SELECT);
+            cell = pq.pop();
+        }
+        bbmStep(cell,prop,repair,local,rng,stats,&pinned,push);
+    }
+
+    for(int x = 0; x < n; x++){
+        for(int y = 0; y < m; y++){
+            if(local(x,y) != OUTSIDE) res(x0+x,y0+y) = local(x,y);
+        }
+    }
+}
+
+// the grid is split into chunkSize x chunkSize chunks, solved in 4 phases by the parity of their
+// chunk coordinates. Chunks of one phase are a whole chunk apart, so with chunkSize >= 2*blockRadius+3
+// the windows solveRegion writes and reads never overlap, and they can run at the same time.
+// Later phases see the chunks around them and repair seam conflicts the same way BBM does
+inline Grid<int> WFCchunked(Rules& rules, Config& config, Rng& rng){
+    int N = config.n;
+    int M = config.m;
+    int C = config.chunkSize;
+    int R = config.blockRadius;
+    if(C < 2*R+3) throw std::invalid_argument("chunkSize must be at least 2*blockRadius+3");
+    Grid<int> res(N,M,-1,1,OUTSIDE);
+
+    int chunksX = (N+C-1)/C;
+    int chunksY = (M+C-1)/C;
+    // every chunk gets its own generator keyed by its coordinates, so the result
+    // doesn't depend on the amount of threads or the order chunks run in
+    uint64_t seed = rng();
+
+    // declared before the pool, so the jobs are done before the contexts go away
+    ContextPool contexts;
+    ThreadPool pool(config.threads);
+    for(int phase = 0; phase < 4; phase++){
+        for(int cx = phase/2; cx < chunksX; cx += 2){
+            for(int cy = phase%2; cy < chunksY; cy += 2){
+                pool.push([&,cx,cy]{
+                    Rng chunkRng(hashKey(seed,cx,cy));
+                    SolverContext* ctx = contexts.take();
+                    solveRegion(rules,res,cx*C,std::min(cx*C+C,N)-1,cy*C,std::min(cy*C+C,M)-1,R,config.minBlockRadius,chunkRng,config.stats,{},ctx);
+                    contexts.give(ctx);
+                });
+            }
+        }
+        pool.wait();
+    }
+
+    return res;
+}
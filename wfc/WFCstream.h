@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "Grid.h"
+#include "ThreadPool.h"
+#include "Context.h"
+#include "WFCchunked.h"
+
+// Streaming generation - an endless world config.m cells wide, made one band of
+// config.chunkSize rows at a time with only two bands in memory
+
+// gets every finished band with the world row it starts at, returning false stops the stream
+typedef std::function<bool(Grid<int>& band, long long firstRow)> BandSink;
+
+// generates bands until the sink returns false, or maxBands of them if maxBands > 0
+// a new band is solved against the band above it and may repair its last blockRadius+1 rows,
+// so a band goes to the sink once the band below it is done, after that nothing changes it
+// each band is split into chunks across, solved in 2 phases like WFCchunked
+inline void WFCstream(Rules& rules, Config& config, Rng& rng, const BandSink& sink, long long maxBands = 0){
+    int B = config.chunkSize;
+    int M = config.m;
+    int C = config.chunkSize;
+    int R = config.blockRadius;
+    if(C < 2*R+3) throw std::invalid_argument("chunkSize must be at least 2*blockRadius+3");
+
+    // rows [0,B) - the band above, rows [B,2B) - the band being made
+    Grid<int> buf(2*B,M,-1,1,OUTSIDE);
+    Grid<int> band(B,M,-1,1,OUTSIDE);
+    int chunksY = (M+C-1)/C;
+    // chunk cy of band k runs on its own generator keyed by (k,cy)
+    uint64_t seed = rng();
+
+    ContextPool contexts;
+    ThreadPool pool(config.threads);
+    for(long long k = 0; maxBands <= 0 || k < maxBands; k++){
+        for(int phase = 0; phase < 2; phase++){
+            for(int cy = phase; cy < chunksY; cy += 2){
+                pool.push([&,cy]{
+                    Rng chunkRng(hashKey(seed,k,cy));
+                    SolverContext* ctx = contexts.take();
+                    solveRegion(rules,buf,B,2*B-1,cy*C,std::min(cy*C+C,M)-1,R,config.minBlockRadius,chunkRng,config.stats,{},ctx);
+                    contexts.give(ctx);
+                });
+            }
+            pool.wait();
+        }
+
+        // the band above is final now
+        if(k > 0){
+            std::copy(&buf(0,-1), &buf(B,-1), &band(0,-1));
+            if(!sink(band,(k-1)*B)) return;
+        }
+        std::copy(&buf(B,-1), &buf(2*B,-1), &buf(0,-1));
+        for(int x = B; x < 2*B; x++){
+            for(int y = 0; y < M; y++) buf(x,y) = -1;
+        }
+        if(maxBands > 0 && k == maxBands-1){
+            std::copy(&buf(0,-1), &buf(B,-1), &band(0,-1));
+            sink(band,k*B);
+        }
+    }
+}
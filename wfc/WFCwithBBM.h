@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "Propagator.h"
+#include "Grid.h"
+#include "IndexedHeap.h"
+#include "Repair.h"
+#include "Context.h"
+
+// Block Based Method - delete blocks when no valid possibility is met
+
+// one step of BBM on the cell just popped, shared by every engine that runs it: a cell that ran out
+// of tiles clears the block around it, repair decides how big, otherwise the cell gets a tile
+// push(cell) queues a cell the step touched if it still has to be filled, pinned cells (if given)
+// keep their tile through a wipe, cells of res that are OUTSIDE are never touched
+template<class Push>
+inline void bbmStep(int cell, Propagator& prop, RepairRadius& repair, Grid<int>& res, Rng& rng, RunStats* stats, const std::vector<char>* pinned, Push push){
+    int x = prop.getX(cell);
+    int y = prop.getY(cell);
+
+    if(prop.domains[cell].empty()){
+        int r = repair.failure(x,y);
+        int minX = std::max(x-r,0);
+        int maxX = std::min(x+r,res.n-1);
+        int minY = std::max(y-r,0);
+        int maxY = std::min(y+r,res.m-1);
+        count(stats,&RunStats::contradictions);
+        count(stats,&RunStats::wipes);
+        count(stats,&RunStats::wipedCells,(maxX-minX+1)*(maxY-minY+1));
+        for(int nx = minX; nx <= maxX; nx++){
+            for(int ny = minY; ny <= maxY; ny++){
+                int next = res.index(nx,ny);
+                if(res[next] == OUTSIDE) continue;
+                // a pin keeps its tile, and gets it back if its neighbours took it away
+                if(pinned && (*pinned)[next]) prop.setTile(next,res[next]);
+                else res[next] = -1;
+            }
+        }
+        prop.resetBlock(minX,maxX,minY,maxY,res);
+        for(int nx = minX; nx <= maxX; nx++){
+            for(int ny = minY; ny <= maxY; ny++){
+                if(nx == minX || nx == maxX || ny == minY || ny == maxY) push(res.index(nx,ny));
+            }
+        }
+    }else{
+        int tileType = prop.pick(rng,cell);
+        res[cell] = tileType;
+        // conflicts are left as empty cells, they get popped first and cleared
+        prop.collapse(cell,tileType,false);
+        repair.success(x,y);
+        for(int i = 0; i < 4; i++) push(cell+prop.delta[i]);
+    }
+    for(int next : prop.changed) push(next);
+    prop.clearChanged();
+}
+
+// fills ctx.res
+inline void solveBBM(Rules& rules, Config& config, Rng& rng, SolverContext& ctx){
+    int N = config.n;
+    int M = config.m;
+    Grid<int>& res = ctx.res;
+    Propagator& prop = ctx.prop;
+    IndexedHeap<double>& pq = ctx.pq;
+    RepairRadius& repair = ctx.repair;
+    res.assign(N,M,-1,1,OUTSIDE);
+    repair.init(N,M,config.minBlockRadius,config.blockRadius);
+
+    prop.useTrail = false;
+    prop.init(rules,N,M);
+    prop.clearChanged();
+
+    // cells are keyed by their propagator index and ordered by their priority
+    pq.init(prop.domains.cells());
+    int start = prop.index(getRandom(rng,0,N-1), getRandom(rng,0,M-1));
+    pq.push(start,prop.priority(start));
+
+    while(!pq.empty()){
+        int cell;
+        {
+            WFC_TIME(PHASE_SELECT);
+            cell = pq.pop();
+        }
+        bbmStep(cell,prop,repair,res,rng,config.stats,nullptr,[&](int next){
+            if(res[next] == -1) pq.push(next,prop.priority(next));
+        });
+    }
+}
+
+inline Grid<int> WFCwithBBM(Rules& rules, Config& config, Rng& rng){
+    SolverContext ctx;
+    solveBBM(rules,config,rng,ctx);
+    return std::move(ctx.res);
+}
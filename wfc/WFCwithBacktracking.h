@@ -0,0 +1,129 @@
+#pragma once
+#include <vector>
+#include <stdexcept>
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "Propagator.h"
+#include "Grid.h"
+#include "Frontier.h"
+#include "Context.h"
+
+// Backtracking to resolve conflicts while generating
+
+// moves the cells touched by the last propagation to their new bucket
+inline void updateBorder(Propagator& prop, Frontier& border){
+    for(int cell : prop.changed){
+        if(border.contains(cell)) border.set(cell,prop.bucket(cell));
+    }
+    prop.clearChanged();
+}
+// undoes decisions until reaching one the conflict depends on, then bans its tile there
+// level and current describe the conflict like in Ban, returns false if there is nothing left to change
+inline bool backjump(std::vector<Decision>& stack, Propagator& prop, Frontier& border, Grid<int>& output, int level, bool current, RunStats* stats = nullptr){
+    WFC_TIME(PHASE_REPAIR);
+    while(!stack.empty()){
+        int k = stack.size()-1;
+        Decision top = stack.back();
+        stack.pop_back();
+        count(stats,&RunStats::backtracks);
+        prop.undo(top.mark);
+        prop.clearChanged();
+        border.undo(top.borderMark);
+        output[top.cell] = -1;
+
+        // decision k-1 is the current one from here
+        // if the conflict depends on it, what else it depends on below is unknown, so assume everything
+        bool onPrev = level == k-1;
+        if(!current){
+            // the conflict doesn't depend on this decision, jump over it
+            current = onPrev;
+            if(onPrev) level = k-2;
+            continue;
+        }
+
+        // the tile can't be used here with the decisions that are left, don't check it again
+        prop.ban(top.cell,top.tile,onPrev ? k-2 : level,onPrev);
+        if(prop.propagate()){
+            prop.finishLevel(k-1);
+            updateBorder(prop,border);
+            return true;
+        }
+        count(stats,&RunStats::contradictions);
+        level = prop.depLevel[prop.conflict];
+        current = prop.depCurrent[prop.conflict];
+        // bans decision k-1 made itself were given its level by finishLevel, it's still the current one
+        if(level == k-1){
+            current = true;
+            level = k-2;
+        }
+    }
+    return false;
+}
+// fills ctx.res
+inline void solveBacktracking(Rules& rules, Config& config, Rng& rng, SolverContext& ctx){
+    int N = config.n;
+    int M = config.m;
+    Grid<int>& res = ctx.res;
+    Propagator& prop = ctx.prop;
+    Frontier& border = ctx.border;
+    res.assign(N,M,-1,1,OUTSIDE);
+    // the context may come from another engine, the trail starts after the first propagation
+    prop.useTrail = false;
+    if(!prop.init(rules,N,M)) throw std::runtime_error("tileset can't fill the grid");
+    prop.useTrail = true;
+    // every ban from here on stays on the trail until it's undone, at most one per tile of every cell
+    prop.trail.reserve((size_t)prop.domains.cells()*rules.tileCount);
+    prop.clearChanged();
+    // the border is the edge of the filled area, it seldom gets longer than the edge of the grid
+    border.init(prop.domains.cells(),rules.tileCount,2*(N+M));
+
+    // decisions are made on an explicit stack instead of recursing once per cell
+    std::vector<Decision>& stack = ctx.stack;
+    stack.clear();
+    stack.reserve(N*M);
+    int start = prop.index(getRandom(rng,0,N-1), getRandom(rng,0,M-1));
+
+    while((int)stack.size() < N*M){
+        // pick next move, the cell with the lowest entropy, without weights the fewest possibilities
+        // the border is only empty before the first decision
+        int cell;
+        {
+            WFC_TIME(PHASE_SELECT);
+            cell = border.empty() ? start : border.top();
+        }
+
+        // fix cell to a random tile
+        int tileType = prop.pick(rng,cell);
+        stack.push_back({cell,tileType,prop.mark(),border.mark()});
+        border.erase(cell);
+        res[cell] = tileType;
+
+        // if the tile empties some cell after propagating, go back to a decision that caused it
+        if(!prop.collapse(cell,tileType)){
+            int conflict = prop.conflict;
+            count(config.stats,&RunStats::contradictions);
+            if(!backjump(stack,prop,border,res,prop.depLevel[conflict],prop.depCurrent[conflict],config.stats)){
+                throw std::runtime_error("tileset can't fill the grid");
+            }
+            continue;
+        }
+        prop.finishLevel(stack.size()-1);
+
+        // update border
+        updateBorder(prop,border);
+        for(int i = 0; i < 4; i++){
+            int next = cell+prop.delta[i];
+            if(res[next] == -1){
+                // if the cell is adjacent and not fixed, add to border
+                border.set(next,prop.bucket(next));
+            }
+        }
+    }
+}
+
+inline Grid<int> WFCwithBacktracking(Rules& rules, Config& config, Rng& rng){
+    SolverContext ctx;
+    solveBacktracking(rules,config,rng,ctx);
+    return std::move(ctx.res);
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include "Rules.h"
+#include "Config.h"
+#include "Random.h"
+#include "Propagator.h"
+#include "Grid.h"
+#include "IndexedHeap.h"
+#include "ThreadPool.h"
+#include "Context.h"
+
+// When a conflict is encountered, reset the grid
+
+// no attempt has won yet
+constexpr long long NO_WINNER = 1LL << 62;
+
+// one try at filling the grid into ctx.res, returns false on a conflict,
+// or once an attempt numbered below this one has won
+// attempts reuse the context, so a reset doesn't allocate again
+inline bool attemptReset(Rules& rules, Config& config, Rng& rng, SolverContext& ctx, const std::atomic<long long>* winner = nullptr, long long attempt = 0){
+    int N = config.n;
+    int M = config.m;
+    Grid<int>& res = ctx.res;
+    Propagator& prop = ctx.prop;
+    IndexedHeap<double>& pq = ctx.pq;
+
+    res.assign(N,M,-1,1,OUTSIDE);
+    prop.useTrail = false;
+    if(!prop.init(rules,N,M)) throw std::runtime_error("tileset can't fill the grid");
+    prop.clearChanged();
+
+    // cells are keyed by their propagator index and ordered by their priority
+    pq.init(prop.domains.cells());
+    int start = prop.index(getRandom(rng,0,N-1), getRandom(rng,0,M-1));
+    pq.push(start,prop.priority(start));
+
+    while(!pq.empty()){
+        if(winner && winner->load(std::memory_order_relaxed) < attempt) return false;
+        int cell;
+        {
+            WFC_TIME(PHASE_SELECT);
+            cell = pq.pop();
+        }
+
+        int tileType = prop.pick(rng,cell);
+        res[cell] = tileType;
+        // a cell ran out of tiles somewhere, start over
+        if(!prop.collapse(cell,tileType)){
+            count(config.stats,&RunStats::contradictions);
+            count(config.stats,&RunStats::restarts);
+            return false;
+        }
+
+        for(int i = 0; i < 4; i++){
+            int next = cell+prop.delta[i];
+            if(res[next] == -1){
+                pq.push(next,prop.priority(next));
+            }
+        }
+        pushChanged(pq,prop,res);
+    }
+    return true;
+}
+
+// attempt i runs on a generator keyed by i, so the result only depends on the seed
+inline Grid<int> WFCwithReset(Rules& rules, Config& config, Rng& rng){
+    uint64_t seed = rng();
+    SolverContext ctx;
+    for(long long attempt = 0; ; attempt++){
+        Rng attemptRng(hashKey(seed,attempt));
+        if(attemptReset(rules,config,attemptRng,ctx)) return std::move(ctx.res);
+    }
+}
+
+// runs the attempts of WFCwithReset on config.threads threads at once, each with its own context
+// the lowest numbered attempt that fills the grid wins, attempts after it stop at their next cell,
+// so the result is the same as WFCwithReset's for the same seed, however many threads run
+inline Grid<int> WFCwithResetParallel(Rules& rules, Config& config, Rng& rng){
+    uint64_t seed = rng();
+    ThreadPool pool(config.threads);
+    std::atomic<long long> next(0);
+    std::atomic<long long> winner(NO_WINNER);
+    std::mutex winnerMtx;
+    Grid<int> result;
+
+    for(int i = 0; i < pool.size(); i++){
+        pool.push([&]{
+            SolverContext ctx;
+            try{
+                while(true){
+                    long long attempt = next++;
+                    if(attempt > winner.load()) break;
+                    Rng attemptRng(hashKey(seed,attempt));
+                    if(!attemptReset(rules,config,attemptRng,ctx,&winner,attempt)) continue;
+                    std::lock_guard<std::mutex> lock(winnerMtx);
+                    if(attempt < winner.load()){
+                        result = std::move(ctx.res);
+                        winner = attempt;
+                    }
+                }
+            }catch(...){
+                winner = -1;
+                throw;
+            }
+        });
+    }
+    pool.wait();
+
+    return result;
+}